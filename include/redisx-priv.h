@@ -28,13 +28,38 @@
 
 #define REDISX_LISTENER_YIELD_COUNT   10  ///< yield after this many processed listener messages, <= 0 to disable yielding
 
+#define SCAN_INITIAL_CURSOR           "0" ///< Initial cursor value for SCAN command.
+
 typedef struct MessageConsumer {
   Redis *redis;
   char *channelStem;          ///< channels stem that incoming channels must begin with to meet for this notification to be activated.
   RedisSubscriberCall func;
+  const void *owner;          ///< The owner (e.g. a cluster) that added the subscriber, or NULL if added by the user.
   struct MessageConsumer *next;
 } MessageConsumer;
 
+struct SubscriberTrie;
+struct SubscriberPool;
+
+
+/**
+ * A pending completion for a pipelined request, in a FIFO of the client, in the same order as the replies arrive.
+ */
+typedef struct RedisCompletion {
+  uint64_t seq;                 ///< Sequence number of the reply on the client (see ClientPrivate.replySeq).
+  RedisReplyCallback call;      ///< Function to call with the reply
+  void *arg;                    ///< User data to pass to the call
+  struct RedisCompletion *next; ///< The next completion in the FIFO, or NULL
+} RedisCompletion;
+
+/**
+ * A reply that nobody asked for, such as the reply to `CLIENT REPLY ON`, which is to be dropped as soon as it
+ * is read, in a FIFO of the client.
+ */
+typedef struct RedisDiscard {
+  int ahead;                    ///< Number of other replies due before this one (after the prior discarded reply).
+  struct RedisDiscard *next;    ///< The next reply to discard, or NULL
+} RedisDiscard;
 
 typedef struct Hook {
   void (*call)(Redis *);
@@ -43,6 +68,28 @@ typedef struct Hook {
 } Hook;
 
 
+/**
+ * A block of memory in an arena, from which the components of a RESP tree are allocated sequentially.
+ * The storage follows the header, at an offset of ARENA_HEADER_SIZE bytes from the start of the block.
+ */
+typedef struct ArenaBlock {
+  struct ArenaBlock *next;      ///< The next block in the chain, or NULL
+  size_t size;                  ///< (bytes) Storage capacity of the block
+  size_t used;                  ///< (bytes) Storage used up in the block
+} ArenaBlock;
+
+/// (bytes) Offset of the storage in an arena block, preserving alignment for any type.
+#define ARENA_HEADER_SIZE     ((sizeof(ArenaBlock) + 15) & ~((size_t) 15))
+
+/**
+ * A chained arena allocator, for RESP trees that are freed all at once. The root RESP of the tree is always the
+ * first allocation from the first block.
+ */
+typedef struct {
+  ArenaBlock *first;            ///< The first block, whose storage begins with the root RESP.
+  ArenaBlock *last;             ///< The current block, from which we allocate.
+} RedisArena;
+
 typedef struct {
   Redis *redis;                 ///< Pointer to the enclosing Redis instance
   enum redisx_channel idx;      ///< e.g. REDISX_INTERACTIVE_CHANNEL, REDISX_PIPELINE_CHANNEL, or REDISX_SUBSCRIPTION_CHANNEL
@@ -51,7 +98,10 @@ typedef struct {
   pthread_mutex_t writeLock;    ///< A lock for writing and requests through this channel...
   pthread_mutex_t readLock;     ///< A lock for reading from the channel...
   pthread_mutex_t pendingLock;  ///< A lock for updating pendingRequests...
-  char in[REDISX_RCVBUF_SIZE];  ///< Local input buffer
+  char *in;                     ///< Local input buffer
+  int inSize;                   ///< [bytes] Size of the input buffer
+  int inLimit;                  ///< [bytes] Size up to which the input buffer may grow as needed.
+  boolean inPinned;             ///< Whether the input buffer is in use by subscribers, and must not be modified.
   int available;                ///< Number of bytes available in the buffer.
   int next;                     ///< Index of next unconsumed byte in buffer.
   int socket;                   ///< Changing the socket should require both locks!
@@ -60,7 +110,24 @@ typedef struct {
   SSL *ssl;
 #endif
   int pendingRequests;          ///< Number of request sent and not yet answered...
+  boolean skipNext;             ///< Whether the next request was set to have no reply (CLIENT REPLY SKIP).
+  boolean noReply;              ///< Whether replies are turned off for all requests (CLIENT REPLY OFF).
+  uint64_t requestSeq;          ///< Number of requests sent that expect a reply, since the client was connected.
+  uint64_t replySeq;            ///< Number of replies received since the client was connected.
+  RedisCompletion *firstCompletion;   ///< The oldest pending completion, or NULL.
+  RedisCompletion *lastCompletion;    ///< The most recent pending completion, or NULL.
+  RedisDiscard *firstDiscard;   ///< The next reply to discard, or NULL.
+  RedisDiscard *lastDiscard;    ///< The last reply to discard, or NULL.
   RESP *attributes;             ///< Attributes from the last packet received.
+  char *out;                    ///< Write coalescing buffer, or NULL
+  int outSize;                  ///< [bytes] Size of the write coalescing buffer, or 0 if not coalescing writes.
+  int outUsed;                  ///< [bytes] Data waiting to be sent in the write coalescing buffer.
+  int outDelayMicros;           ///< [us] Maximum time data may wait in the write coalescing buffer.
+  struct timespec outSince;     ///< Time the oldest data in the write coalescing buffer was added.
+  pthread_cond_t outCond;       ///< Signals the flusher thread (with writeLock) when data is added to the buffer.
+  pthread_t flusherTID;         ///< Flusher thread, which sends out data waiting for too long in the buffer.
+  boolean hasFlusher;           ///< Whether there is a flusher thread running for the client.
+  boolean stopFlusher;          ///< Tells the flusher thread to stop.
 } ClientPrivate;
 
 typedef struct {
@@ -95,7 +162,16 @@ typedef struct {
   char *password;               ///< Redis password (if any)
   int timeoutMillis;            ///< [ms] Socket read/write timeout
   int tcpBufSize;               ///< [bytes] TCP read/write buffer sizes to use
+  int rcvBufSize[REDISX_CHANNELS];    ///< [bytes] Client receive buffer sizes, or <= 0 for default
+  int rcvBufLimit[REDISX_CHANNELS];   ///< [bytes] Size up to which client receive buffers may grow.
   int protocol;                 ///< RESP version to use
+  boolean useEventLoop;         ///< Whether to service pipeline and subscription clients from the shared event loop
+  int poolSize;                 ///< Number of interactive connections to use, or <= 1 for a single one.
+  int coalesceSize;             ///< [bytes] Pipeline write coalescing buffer size, or <= 0 to send requests immediately.
+  int coalesceMicros;           ///< [us] Maximum time pipeline requests may wait in the coalescing buffer.
+  int subscriberWorkers;        ///< Number of threads dispatching PUB/SUB messages, or <= 0 to dispatch on the listener.
+  int subscriberQueue;          ///< Number of messages that may wait for each dispatch thread.
+  boolean dropMessages;         ///< Whether to drop messages when a dispatch queue is full, rather than wait.
   boolean hello;                ///< whether to use HELLO (introduced in Redis 6.0.0 only)
   RedisSocketConfigurator socketConf;   ///< Additional user configuration of client sockets
 
@@ -119,6 +195,8 @@ typedef struct {
 
   RedisSentinel *sentinel;      ///< Sentinel (high-availability) server configuration.
   RedisCluster *cluster;        ///< Cluster, in which this instance is a member
+  boolean isReplica;            ///< Whether this instance is a replica in its cluster shard.
+  int latencyMicros;            ///< [us] Round-trip time measured when last connected, or 0 if unknown.
 
   int in_family;                ///< AF_INET or AF_INET6
   union {
@@ -134,7 +212,12 @@ typedef struct {
   RESP *helloData;              ///< RESP data received from server during last connection.
 
   RedisClient *clients;
+  RedisClient *pool;            ///< Additional interactive clients, or NULL
+  int poolSize;                 ///< Number of additional interactive clients in the pool
+  int poolNext;                 ///< Pooled client to wait on next, when all are busy
   int scanCount;                ///< Count argument to use in SCAN commands, or <= 0 for default
+  int scanTargetMicros;         ///< [us] Target page latency for adapting the SCAN count, or <= 0 to keep it fixed
+  boolean scanPrefetch;         ///< Whether to request the next page of SCAN results while processing the current one
 
   pthread_t pipelineListenerTID;
   pthread_t subscriptionListenerTID;
@@ -144,6 +227,10 @@ typedef struct {
 
   pthread_mutex_t subscriberLock;
   MessageConsumer *subscriberList;
+  struct SubscriberTrie *subscriberIndex; ///< Prefix trie of subscribers by channel stem, read without locking
+  struct SubscriberTrie *retiredIndex;    ///< Prior subscriber indices, waiting to be freed
+  int subscriberReaders;        ///< Number of threads currently dispatching messages from the subscriber index
+  struct SubscriberPool *subscriberPool;  ///< Threads dispatching PUB/SUB messages, or NULL
 
 } RedisPrivate;
 
@@ -152,9 +239,24 @@ int rCopyConfig(const RedisConfig *src, Redis *dst);
 void rClearConfig(RedisConfig *config);
 XLookupTable *rConsumeInfoReply(RESP *reply);
 
+// in redisx-client.c --------------------->
+boolean rCompleteRequestAsync(RedisClient *cl, RESP *reply);
+RedisClient *rLockInteractive(Redis *redis, int *pStatus);
+RedisClient *rTryLockInteractive(Redis *redis);
+int rSetCoalescing(RedisClient *cl, int size, int delayMicros);
+void rCancelRequestsAsync(ClientPrivate *cp);
+int rReadMessageAsync(RedisClient *cl);
+int rSendScatterRequestAsync(RedisClient *cl, const char **args, int n, const struct iovec *parts, int nParts);
+
 // in redisx-sub.c ------------------------>
 int rConfigLock(Redis *redis);
 int rConfigUnlock(Redis *redis);
+void rProcessSubscriptionReply(Redis *redis, RESP *reply);
+void rDestroySubscriberPool(RedisPrivate *p);
+int rAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCall f, const void *owner);
+int rRemoveSubscribers(Redis *redis, RedisSubscriberCall f, const void *owner);
+int rSendSubscriptionCommand(Redis *redis, const char *command, const char *channel);
+void rProcessSubscriptionMessage(Redis *redis, char **part, const int *len, int n);
 
 // in redisx-net.c ------------------------>
 int rConnectAsync(Redis *redis, boolean usePipeline);
@@ -162,9 +264,17 @@ int rConnectClientAsync(Redis *redis, enum redisx_channel channel);
 void rCloseClient(RedisClient *cl);
 void rCloseClientAsync(RedisClient *cl);
 boolean rIsLowLatency(const ClientPrivate *cp);
+int rSetReceiveBufferAsync(ClientPrivate *cp, int size, int limit);
+void rUnpinReceiveBufferAsync(ClientPrivate *cp);
 int rCheckClient(const RedisClient *cl);
 int rSetServerAsync(Redis *redis, const char *desc, const char *hostname, int port);
 void rDisconnectAsync(Redis *redis);
+void rProcessPipelineReply(Redis *redis, RESP *reply);
+
+// in redisx-loop.c ----------------------->
+int rLoopAddClientAsync(RedisClient *cl);
+void rLoopRemoveClientAsync(RedisClient *cl);
+boolean rIsEventLoopThread(void);
 
 // in redisx-hooks.c ---------------------->
 Hook *rCopyHooks(const Hook *list, Redis *owner);
@@ -172,8 +282,12 @@ void rClearHooks(Hook *first);
 
 // in redisx-cluster.c -------------------->
 int rClusterRefresh(RedisCluster *cluster);
+void rClusterShardUnsubscribed(RedisCluster *cluster, Redis *redis, const char *channel);
 uint16_t rCalcHash(const char *key);
 
+// in redisx-tab.c ------------------------>
+int rSortKeys(char **keys, int n);
+
 // in redisx-tls.c ------------------------>
 #if WITH_TLS
 void rClearTLSConfig(TLSConfig *tls);
@@ -182,6 +296,9 @@ int rCopyTLSConfig(const TLSConfig *src, TLSConfig *dst);
 
 // in resp.c ------------------------------>
 int redisxAppendRESP(RESP *resp, RESP *part);
+int rAppendRESP(RedisArena *arena, RESP *resp, RESP *part);
+void *rArenaAlloc(RedisArena *arena, size_t size);
+void rArenaFree(RedisArena *arena);
 
 /// \endcond
 
@@ -17,6 +17,7 @@
 #include <xchange.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <sys/uio.h>
 
 // API version constants --------------------------------------------------------->
 
@@ -51,10 +52,20 @@
 #endif
 
 #ifndef REDISX_RCVBUF_SIZE
-/// (bytes) Redis receive buffer size (at most that much is read from the socket in a single call).
+/// (bytes) Default Redis receive buffer size (at most that much is read from the socket in a single call).
 #  define REDISX_RCVBUF_SIZE              8192
 #endif
 
+#ifndef REDISX_COALESCE_DELAY_MICROS
+/// [us] Default maximum time pipelined requests may wait in the coalescing buffer, before they are sent.
+#  define REDISX_COALESCE_DELAY_MICROS    100
+#endif
+
+#ifndef REDISX_SUBSCRIBER_QUEUE_LENGTH
+/// Default number of messages that may wait for each subscriber dispatch worker.
+#  define REDISX_SUBSCRIBER_QUEUE_LENGTH  1024
+#endif
+
 #ifndef REDISX_SET_LISTENER_PRIORITY
 /// Whether to explicitly set listener thread priorities
 #  define REDISX_SET_LISTENER_PRIORITY    FALSE
@@ -163,6 +174,19 @@ enum redisx_protocol {
   REDISX_RESP3                        ///< \hideinitializer RESP3 protocol (since Redis version 6.0.0)
 };
 
+/**
+ * Policy for selecting the cluster node to use for read-only queries.
+ *
+ * @sa redisxClusterSetReadPreference()
+ * @sa redisxClusterGetReadShard()
+ */
+enum redisx_read_pref {
+  REDISX_READ_MASTER = 0,             ///< \hideinitializer Read from the master only (default)
+  REDISX_READ_PREFER_REPLICA,         ///< \hideinitializer Read from a replica, or from the master if no replica is available
+  REDISX_READ_NEAREST,                ///< \hideinitializer Read from the node with the lowest round-trip time
+  REDISX_READ_ROUND_ROBIN             ///< \hideinitializer Rotate reads among all nodes serving the keys
+};
+
 /**
  * \brief Structure that represents a Redis response (RESP format).
  *
@@ -210,6 +234,15 @@ typedef struct RedisEntry {
   int length;                   ///< Bytes in value.
 } RedisEntry;
 
+/**
+ * An iterator over the entries of a Redis hash table, which are retrieved page by page.
+ *
+ * @sa redisxTableIteratorOpen()
+ */
+typedef struct {
+  void *priv;                   ///< Private data not exposed to users.
+} RedisTableIterator;
+
 
 
 
@@ -349,6 +382,26 @@ typedef void (*RedisErrorHandler)(Redis *redis, enum redisx_channel channel, con
  */
 typedef void (*RedisPipelineProcessor)(RESP *response);
 
+/**
+ * A user-defined function for processing the response to a specific pipelined request, submitted via
+ * redisxSendRequestCb(). The same rules apply as for RedisPipelineProcessor: the implementation should not
+ * destroy the RESP data, nor block for long, since it is called from the pipeline listener.
+ *
+ * @param reply       The response to the request, or NULL if the request was not answered because the pipeline
+ *                    client was closed. (In the latter case, the call should not use the pipeline client.)
+ * @param userData    The user data pointer that was supplied with the request.
+ *
+ * @sa redisxSendRequestCb()
+ */
+typedef void (*RedisReplyCallback)(RESP *reply, void *userData);
+
+/**
+ * An opaque handle to the eventual reply of a pipelined request.
+ *
+ * @sa redisxSendRequestFuture()
+ */
+typedef struct RedisFuture RedisFuture;
+
 /**
  * A user-defined function for consuming push messages from a Redis client. The implementation
  * should follow a set of simple rules:
@@ -380,6 +433,23 @@ typedef void (*RedisPipelineProcessor)(RESP *response);
  */
 typedef void (*RedisPushProcessor)(RedisClient *cl, RESP *message, void *ptr);
 
+/**
+ * A user-defined function for processing a page of keys from a cluster-wide scan, via redisxClusterStreamKeys().
+ * It is called from the thread that started the scan, while the interactive clients of the cluster's masters are
+ * locked for the scan. Thus, it should not make interactive requests to the cluster, but it may use pipelined
+ * requests.
+ *
+ * @param shard       The cluster master on which the keys were scanned.
+ * @param keys        The keys. They are valid only until the function returns, and should not be modified
+ *                    or freed. The function should copy the keys it wants to keep.
+ * @param n           The number of keys.
+ * @param ptr         The user data pointer that was supplied with the scan.
+ * @return            0 to continue the scan, or else a non-zero value to stop it.
+ *
+ * @sa redisxClusterStreamKeys()
+ */
+typedef int (*RedisKeyProcessor)(Redis *shard, const char **keys, int n, void *ptr);
+
 /**
  * User callback function allowing additional customization of the client socket before connection.
  *
@@ -398,6 +468,16 @@ void redisxDebugTraffic(boolean value);
 int redisxSetReplyTimeout(Redis *redis, int timeoutMillis);
 int redisxSetSocketTimeout(Redis *redis, int millis);
 int redisxSetTcpBuf(Redis *redis, int size);
+int redisxSetReceiveBufferSize(Redis *redis, enum redisx_channel channel, int size);
+int redisxSetReceiveBufferLimit(Redis *redis, enum redisx_channel channel, int limit);
+int redisxGetReceiveBufferSize(Redis *redis, enum redisx_channel channel);
+int redisxSetInteractivePoolSize(Redis *redis, int n);
+int redisxSetPipelineCoalescing(Redis *redis, int size, int delayMicros);
+int redisxGetInteractivePoolSize(Redis *redis);
+int redisxUseEventLoop(Redis *redis, boolean value);
+int redisxStartEventLoop(int threads);
+int redisxStopEventLoop(void);
+boolean redisxIsEventLoopRunning(void);
 int redisxSetSentinelTimeout(Redis *redis, int millis);
 int redisxSetSocketConfigurator(Redis *redis, RedisSocketConfigurator func);
 int redisxSetSocketErrorHandler(Redis *redis, RedisErrorHandler f);
@@ -411,6 +491,7 @@ int redisxSetProtocol(Redis *redis, enum redisx_protocol protocol);
 
 Redis *redisxInit(const char *server);
 Redis *redisxInitSentinel(const char *serviceName, const RedisServer *serverList, int nServers);
+Redis *redisxInitSentinelReplica(Redis *redis);
 int redisxValidateSentinel(const char *serviceName, const RedisServer *serverList, int nServers);
 int redisxCheckValid(const Redis *redis);
 void redisxDestroy(Redis *redis);
@@ -428,14 +509,28 @@ int redisxSetTLSVerify(Redis *redis, boolean value);
 
 RedisCluster *redisxClusterInit(Redis *node);
 Redis *redisxClusterGetShard(RedisCluster *cluster, const char *key);
+int redisxClusterHashSlots(const char **keys, int n, uint16_t *slots);
 boolean redisxClusterIsRedirected(const RESP *reply);
 boolean redisxClusterMoved(const RESP *reply);
 boolean redisxClusterIsMigrating(const RESP *reply);
 int redisxClusterConnect(RedisCluster *cluster);
 int redisxClusterDisconnect(RedisCluster *cluster);
+int redisxClusterSetRefreshInterval(RedisCluster *cluster, int millis);
+int redisxClusterSetReadPreference(RedisCluster *cluster, enum redisx_read_pref pref);
+Redis *redisxClusterGetReadShard(RedisCluster *cluster, const char *key);
 void redisxClusterDestroy(RedisCluster *cluster);
 Redis *redisxClusterGetRedirection(RedisCluster *cluster, const RESP *redirect, boolean refresh);
 RESP *redisxClusterAskMigrating(Redis *redis, const char **args, const int *lengths, int n, int *status);
+RESP *redisxClusterMGet(RedisCluster *cluster, const char **keys, int n, int *status);
+int redisxClusterMSet(RedisCluster *cluster, const RedisEntry *entries, int n);
+int redisxClusterDelete(RedisCluster *cluster, const char **keys, int n);
+char **redisxClusterScanKeys(RedisCluster *cluster, const char *pattern, int *n, int *status);
+int redisxClusterStreamKeys(RedisCluster *cluster, const char *pattern, RedisKeyProcessor f, void *ptr);
+int redisxClusterAddSubscriber(RedisCluster *cluster, const char *channelStem, RedisSubscriberCall f);
+int redisxClusterRemoveSubscribers(RedisCluster *cluster, RedisSubscriberCall f);
+int redisxClusterSubscribe(RedisCluster *cluster, const char *channel);
+int redisxClusterUnsubscribe(RedisCluster *cluster, const char *channel);
+int redisxClusterPublish(RedisCluster *cluster, const char *channel, const char *data, int length);
 
 int redisxPing(Redis *redis, const char *message);
 enum redisx_protocol redisxGetProtocol(Redis *redis);
@@ -463,13 +558,19 @@ int redisxGetAvailable(RedisClient *cl);
 int redisxSetValue(Redis *redis, const char *table, const char *key, const char *value, boolean confirm);
 RESP *redisxGetValue(Redis*redis, const char *table, const char *key, int *status);
 char *redisxGetStringValue(Redis *redis, const char *table, const char *key, int *len);
+int redisxGetValueInto(Redis *redis, const char *table, const char *key, char *buf, int size);
 RedisEntry *redisxGetTable(Redis *redis, const char *table, int *n);
 RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern, int *n);
+RedisTableIterator *redisxTableIteratorOpen(Redis *redis, const char *table, const char *pattern, boolean dedupe);
+const RedisEntry *redisxTableIteratorNext(RedisTableIterator *it, int *n);
+void redisxTableIteratorClose(RedisTableIterator *it);
 int redisxMultiSet(Redis *redis, const char *table, const RedisEntry *entries, int n, boolean confirm);
 char **redisxGetKeys(Redis *redis, const char *table, int *n);
 char **redisxScanKeys(Redis *redis, const char *pattern, int *n);
 int redisxSetScanCount(Redis *redis, int count);
 int redisxGetScanCount(Redis *redis);
+int redisxSetScanTargetLatency(Redis *redis, int micros);
+int redisxSetScanPrefetch(Redis *redis, boolean value);
 void redisxDestroyEntries(RedisEntry *entries, int count);
 void redisxDestroyKeys(char **keys, int count);
 
@@ -477,10 +578,12 @@ int redisxSetPipelineConsumer(Redis *redis, RedisPipelineProcessor f);
 int redisxSetPushProcessor(Redis *redis, RedisPushProcessor func, void *arg);
 
 int redisxPublish(Redis *redis, const char *channel, const char *message, int length);
+int redisxPublishV(Redis *redis, const char *channel, const struct iovec *parts, int n);
 int redisxNotify(Redis *redis, const char *channel, const char *message);
 int redisxSubscribe(Redis *redis, const char *channel);
 int redisxUnsubscribe(Redis *redis, const char *channel);
 int redisxAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCall f);
+int redisxSetSubscriberWorkers(Redis *redis, int n, int queueLength, boolean dropOnOverflow);
 int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f);
 int redisxClearSubscribers(Redis *redis);
 int redisxEndSubscription(Redis *redis);
@@ -498,6 +601,7 @@ RESP *redisxCopyOfRESP(const RESP *resp);
 int redisxCheckRESP(const RESP *resp, enum resp_type expectedType, int expectedSize);
 int redisxCheckDestroyRESP(RESP *resp, enum resp_type, int expectedSize);
 void redisxDestroyRESP(RESP *resp);
+void redisxDestroyArenaRESP(RESP *resp);
 boolean redisxIsScalarType(const RESP *r);
 boolean redisxIsStringType(const RESP *r);
 boolean redisxIsArrayType(const RESP *r);
@@ -527,11 +631,25 @@ int redisxSetValueAsync(RedisClient *cl, const char *table, const char *key, con
 int redisxMultiSetAsync(RedisClient *cl, const char *table, const RedisEntry *entries, int n, boolean confirm);
 int redisxGetAvailableAsync(RedisClient *cl);
 RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus);
+RESP *redisxReadArenaReplyAsync(RedisClient *cl, int *pStatus);
+int redisxReadBulkStringAsync(RedisClient *cl, char *buf, int size);
 int redisxClearAttributesAsync(RedisClient *cl);
 const RESP *redisxGetAttributesAsync(const RedisClient *cl);
 int redisxIgnoreReplyAsync(RedisClient *cl);
 int redisxSkipReplyAsync(RedisClient *cl);
+int redisxStartNoReplyAsync(RedisClient *cl);
+int redisxEndNoReplyAsync(RedisClient *cl);
+int redisxFlushAsync(RedisClient *cl);
+int redisxSendRequestCb(Redis *redis, const char **args, const int *lengths, int n, RedisReplyCallback f, void *userData);
+RedisFuture *redisxSendRequestFuture(Redis *redis, const char **args, const int *lengths, int n, int *pStatus);
+boolean redisxIsFutureDone(RedisFuture *f);
+int redisxWaitFuture(RedisFuture *f, int timeoutMillis);
+int redisxWaitAnyFuture(RedisFuture **futures, int n, int timeoutMillis);
+int redisxWaitAllFutures(RedisFuture **futures, int n, int timeoutMillis);
+RESP *redisxTakeFutureReply(RedisFuture *f);
+void redisxDestroyFuture(RedisFuture *f);
 int redisxPublishAsync(Redis *redis, const char *channel, const char *data, int length);
+int redisxPublishVAsync(Redis *redis, const char *channel, const struct iovec *parts, int n);
 
 
 // Error generation with stderr message...
@@ -542,5 +660,6 @@ const char* redisxErrorDescription(int code);
 #if FNMATCH || _POSIX_C_SOURCE >= 200112L
 int redisxDeleteEntries(Redis *redis, const char *pattern);
 #endif
+int redisxDeleteEntriesOnServer(Redis *redis, const char *pattern);
 
 #endif /* REDISX_H_ */
@@ -14,8 +14,10 @@
 #include <limits.h>
 #include <ctype.h>
 #include <poll.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #if __Lynx__
 #  include <socket.h>
 #else
@@ -39,6 +41,9 @@
 #  define SEND_YIELD_COUNT          (-1)
 #endif
 
+#define SEND_IOV_COUNT            64        ///< Maximum number of memory segments to send in one go
+#define SEND_INLINE_SIZE          1024      ///< (bytes) Request arguments up to this size are copied into the send buffer.
+
 #define trprintf if(debugTraffic) printf  ///< Use for debugging Redis bound traffic
 
 int debugTraffic = FALSE;    ///< Whether to print excerpts of all traffic to/from the Redis server.
@@ -92,15 +97,18 @@ static int rTransmitErrorAsync(ClientPrivate *cp, const char *op) {
 }
 
 /**
- * Reads a chunk of data into the client's receive holding buffer.
+ * Receives up to the specified number of bytes from the client's socket into the specified buffer,
+ * waiting for data to become available for up to the client's timeout.
  *
  * @param cp        Pointer to the private data of the client.
- * @return          X_SUCCESS (0) if successful, or else an appropriate error (see xchange.h).
+ * @param dst       Buffer in which to receive data.
+ * @param size      Maximum number of bytes to receive.
+ * @return          The number of bytes received (&gt;0), or else an appropriate error (see xchange.h).
  */
-static int rReadChunkAsync(ClientPrivate *cp) {
+static int rReceiveAsync(ClientPrivate *cp, char *dst, int size) {
   const int sock = cp->socket;      // Local copy of socket fd that won't possibly change mid-call.
   struct pollfd pfd;
-  int status;
+  int n;
 
   memset(&pfd, 0, sizeof(pfd));
 
@@ -113,39 +121,72 @@ static int rReadChunkAsync(ClientPrivate *cp) {
   pfd.fd = sock;
   pfd.events = POLLIN;
 
-  status = poll(&pfd, 1, cp->timeoutMillis > 0 ? cp->timeoutMillis : -1);
+  n = poll(&pfd, 1, cp->timeoutMillis > 0 ? cp->timeoutMillis : -1);
 
-  if(status < 1) cp->available = status;
+  if(n < 1) n = -1;                 // poll() error or timeout
   else if(pfd.revents & POLLIN) {
-    cp->next = 0;
-
 #if WITH_TLS
     if(cp->ssl) {
       // For SSL we cannot have concurrent reads/writes...
       pthread_mutex_lock(&cp->writeLock);
-      cp->available = SSL_read(cp->ssl, cp->in, REDISX_RCVBUF_SIZE);
+      n = SSL_read(cp->ssl, dst, size);
       pthread_mutex_unlock(&cp->writeLock);
     }
     else
 #endif
-    cp->available = recv(sock, cp->in, REDISX_RCVBUF_SIZE, 0);
-    trprintf(" ... read %d bytes from client %d socket.\n", cp->available, (int) cp->idx);
+    n = recv(sock, dst, size, 0);
+    trprintf(" ... read %d bytes from client %d socket.\n", n, (int) cp->idx);
   }
-  else cp->available = -1;
-
-  if(cp->socket >= 0 && cp->available <= 0) {
-    status = rTransmitErrorAsync(cp, "read");
-    if(cp->available == 0) errno = ECONNRESET;        // 0 return is remote cleared connection. So set ECONNRESET...
-    if(cp->isEnabled) x_trace("rReadChunkAsync", NULL, status);
+  else n = -1;
+
+  if(n <= 0) {
+    int status = X_NO_SERVICE;
+    if(cp->socket >= 0) {
+      status = rTransmitErrorAsync(cp, "read");
+      if(n == 0) errno = ECONNRESET;        // 0 return is remote cleared connection. So set ECONNRESET...
+      if(cp->isEnabled) x_trace("rReadChunkAsync", NULL, status);
+    }
     return status;
   }
+
+  return n;
+}
+
+/**
+ * Reads a chunk of data into the client's receive holding buffer. If the data fills the buffer entirely, the
+ * buffer is grown for subsequent reads, up to the limit that was set for the client.
+ *
+ * @param cp        Pointer to the private data of the client.
+ * @return          X_SUCCESS (0) if successful, or else an appropriate error (see xchange.h).
+ */
+static int rReadChunkAsync(ClientPrivate *cp) {
+  int n;
+
+  rUnpinReceiveBufferAsync(cp);
+
+  n = rReceiveAsync(cp, cp->in, cp->inSize);
+
+  cp->next = 0;
+  cp->available = n > 0 ? n : 0;
+
+  if(n < 0) return n;
+
+  if(n == cp->inSize && cp->inSize < cp->inLimit) {
+    // We filled the buffer entirely, so grow it (if allowed) for more efficient reads.
+    int size = cp->inSize < (cp->inLimit >> 1) ? (cp->inSize << 1) : cp->inLimit;
+    rSetReceiveBufferAsync(cp, size, cp->inLimit);
+  }
+
   return X_SUCCESS;
 }
 
 /**
  * Tries to read a Redis "\r\n" terminated token into the specified buffer, using up to the specified amount
  * of space available, without the CR+LF termination used by Redis. The string returned in the supplied buffer
- * is properly terminated with '\0'.
+ * is properly terminated with '\0'. Rather than consuming the input byte-by-byte, it locates the LF termination
+ * in the buffered input with memchr(), and copies whole segments of the token at once.
+ *
+ * The caller must hold the read lock of the client.
  *
  * \param cp       Pointer to the private data of a Redis channel.
  * \param buf      Pointer to the buffer in which the token (or part of it) will be stored.
@@ -154,81 +195,78 @@ static int rReadChunkAsync(ClientPrivate *cp) {
  * \return         The number of characters read into the buffer (excluding the CR+LF termination in the stream).
  *                 Values < 0 indicate an error.
  */
-static int rReadToken(ClientPrivate *cp, char *buf, int length) {
+static int rReadTokenAsync(ClientPrivate *cp, char *buf, int length) {
   static const char *fn = "rReadToken";
-  int foundTerms = 0, L;
+  int L = 0, total = 0;
+  char last = '\0';      // The last character consumed from the input.
 
   length--; // leave room for termination in incomplete tokens...
 
-  pthread_mutex_lock(&cp->readLock);
+  *buf = '\0';
 
-  if(!cp->isEnabled) {
-    pthread_mutex_unlock(&cp->readLock);
-    return x_error(X_NO_SERVICE, ENOTCONN, fn, "client is not connected");
-  }
+  for(;;) {
+    const char *from, *eol;
+    int n;
 
-  for(L=0; cp->isEnabled && foundTerms < 2; L++) {
-    char c;
+    if(!cp->isEnabled) {
+      if(total > 0) return x_trace(fn, NULL, X_NO_SERVICE);
+      return x_error(X_NO_SERVICE, ENOTCONN, fn, "client is not connected");
+    }
 
     // Read a chunk of available data from the socket...
     if(cp->next >= cp->available) {
       int status = rReadChunkAsync(cp);
       if(status) {
-        pthread_mutex_unlock(&cp->readLock);
         if(cp->isEnabled) return x_trace(fn, NULL, status);
         return status;
       }
     }
 
-    c = cp->in[cp->next++];
+    from = &cp->in[cp->next];
+    n = cp->available - cp->next;
 
-    switch(c) {
-      case '\r' :
-        foundTerms = 1;
-        break;
-      case '\n' :
-        foundTerms = (foundTerms == 1) ? 2 : 0;
-        break;
-      default:
-        foundTerms = 0;
-    }
+    eol = (const char *) memchr(from, '\n', n);
+    if(eol) n = (int) (eol - from) + 1;        // consume up to and including the LF
 
     // buffer only up to the allowed number of characters in buf...
-    if(L < length) buf[L] = c;
-  }
+    if(L < length) {
+      int k = (n < length - L) ? n : length - L;
+      memcpy(&buf[L], from, k);
+      L += k;
+    }
 
-  pthread_mutex_unlock(&cp->readLock);
+    cp->next += n;
+    total += n;
 
-  // If client was disabled before we got everything, then simply return X_NO_SERVICE
-  if(!cp->isEnabled) {
-    *buf = '\0';
-    if(L > 0) return x_trace(fn, NULL, X_NO_SERVICE);
-    return X_NO_SERVICE;
-  }
+    if(eol) {
+      // LF must be preceded by CR, possibly at the end of the previous chunk.
+      if((n > 1 ? eol[-1] : last) == '\r') break;
+    }
 
-  // From here on L is the number of characters actually buffered.
-  if(L > length) L = length-1;
+    last = from[n - 1];
+  }
 
-  // Discard "\r\n"
-  if(foundTerms == 2) L -= 2;
+  // From here on L is the number of characters in the token, without the "\r\n".
+  L = total - 2;
+  if(L > length) L = length;
 
   // Terminate string in buffer
   buf[L] = '\0';
 
   trprintf("[%s]\n", buf);
 
-  if(*buf == RESP_ERROR) {
-    fprintf(stderr, "Redis-X> error message: %s\n", &buf[1]);
-    return L;
-  }
+  if(*buf == RESP_ERROR) fprintf(stderr, "Redis-X> error message: %s\n", &buf[1]);
 
-  return foundTerms==2 ? L : x_error(REDIS_INCOMPLETE_TRANSFER, EBADMSG, fn, "missing \\r\\n termination");
+  return L;
 }
 
 /**
- * Like readToken() except it will always read 'length' number of bytes (not checking for \r\n termination)
- * It is useful mainly to read binary BULK_STRING content. For everything else, readToken() is your better
- * bet...
+ * Like rReadTokenAsync() except it will always read 'length' number of bytes (not checking for \r\n termination)
+ * It is useful mainly to read binary BULK_STRING content. For everything else, rReadTokenAsync() is your better
+ * bet... Data that is already buffered is copied in one go, while large payloads are received directly into
+ * the destination buffer.
+ *
+ * The caller must hold the read lock of the client.
  *
  * \param[in]  cp        Pointer to a Redis client's private data.
  * \param[out] buf       The buffer to read into, or NULL to just consume bytes from the input.
@@ -236,31 +274,43 @@ static int rReadToken(ClientPrivate *cp, char *buf, int length) {
  *
  * \return     Number of bytes successfully read (>=0), or else X_NO_SERVICE.
  */
-static int rReadBytes(ClientPrivate *cp, char *buf, int length) {
+static int rReadBytesAsync(ClientPrivate *cp, char *buf, int length) {
   static const char *fn = "rReadBytes";
-  int L;
+  int L = 0;
 
-  pthread_mutex_lock(&cp->readLock);
+  while(L < length) {
+    int n;
 
-  if(!cp->isEnabled) {
-    pthread_mutex_unlock(&cp->readLock);
-    return x_error(X_NO_SERVICE, ENOTCONN, fn, "client not connected");
-  }
+    if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client not connected");
 
-  for(L=0; cp->isEnabled && L<length; L++) {
-    // Read a chunk of available data from the socket...
     if(cp->next >= cp->available) {
-      int status = rReadChunkAsync(cp);
-      if(status) {
-        pthread_mutex_unlock(&cp->readLock);
-        if(cp->isEnabled) return x_trace(fn, NULL, status);
+      if(buf && length - L >= cp->inSize) {
+        // Large payload: receive directly into the destination, without going through the holding buffer.
+        n = rReceiveAsync(cp, &buf[L], length - L);
+        if(n < 0) {
+          if(cp->isEnabled) return x_trace(fn, NULL, n);
+          return n;
+        }
+        L += n;
+        continue;
+      }
+
+      // Read a chunk of available data from the socket...
+      n = rReadChunkAsync(cp);
+      if(n) {
+        if(cp->isEnabled) return x_trace(fn, NULL, n);
+        return n;
       }
     }
 
-    if(buf) buf[L] = cp->in[cp->next++];
-  }
+    n = cp->available - cp->next;
+    if(n > length - L) n = length - L;
 
-  pthread_mutex_unlock(&cp->readLock);
+    if(buf) memcpy(&buf[L], &cp->in[cp->next], n);
+
+    cp->next += n;
+    L += n;
+  }
 
   return L;
 }
@@ -279,8 +329,8 @@ static int rReadBytes(ClientPrivate *cp, char *buf, int length) {
  *                      an error with send().
  *
  */
-static int rSendBytesAsync(ClientPrivate *cp, const char *buf, int length, boolean isLast) {
-  static const char *fn = "rSendBytesAsync";
+static int rWriteBytesAsync(ClientPrivate *cp, const char *buf, int length, boolean isLast) {
+  static const char *fn = "rWriteBytesAsync";
 
 #if SEND_YIELD_COUNT > 0
   static int count;   // Total bytes sent;
@@ -332,6 +382,331 @@ static int rSendBytesAsync(ClientPrivate *cp, const char *buf, int length, boole
   return X_SUCCESS;
 }
 
+/**
+ * Sends a sequence of memory segments to the desired socket, in as few calls as possible (via sendmsg()),
+ * without copying them first.
+ *
+ * \param cp            Pointer to the private data of the client.
+ * \param iov           Array of memory segments to send. The array may be modified by the call.
+ * \param n             The number of segments in the array.
+ * \param isLast        TRUE if this is the last component of a longer message, or FALSE
+ *                      if more data will follow imminently.
+ * \return              0 if the data was successfully sent, or X_NO_SERVICE if there was
+ *                      an error with sendmsg().
+ *
+ * @sa rWriteBytesAsync()
+ */
+static int rWriteVectorAsync(ClientPrivate *cp, struct iovec *iov, int n, boolean isLast) {
+  static const char *fn = "rWriteVectorAsync";
+
+#if SEND_YIELD_COUNT > 0
+  static int count;   // Total bytes sent;
+#endif
+
+  const int sock = cp->socket;      // Local copy of socket fd that won't possibly change mid-call.
+
+#if WITH_TLS
+  if(cp->ssl) {
+    // No vectored write with TLS, so send segment by segment...
+    int i;
+    for(i = 0; i < n; i++) prop_error(fn, rWriteBytesAsync(cp, (char *) iov[i].iov_base, (int) iov[i].iov_len, isLast && i == (n-1)));
+    return X_SUCCESS;
+  }
+#endif
+
+  trprintf("\n ... write %d segments to client %d socket\n", n, (int) cp->idx);
+
+  if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client %d: disabled", (int) cp->idx);
+  if(sock < 0) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client %d: not connected", (int) cp->idx);
+
+  while(n > 0) {
+    struct msghdr msg;
+    ssize_t sent;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n;
+
+#if __linux__
+    // Linux supports flagging outgoing messages to inform it whether or not more
+    // imminent data is on its way
+    sent = sendmsg(sock, &msg, isLast ? (rIsLowLatency(cp) ? MSG_EOR : 0) : MSG_MORE);
+#else
+    // Stay safe and send messages with no flag (see rWriteBytesAsync())
+    sent = sendmsg(sock, &msg, 0);
+#endif
+
+    if(sent <= 0) {
+      int status = rTransmitErrorAsync(cp, "send");
+      if(cp->isEnabled) x_trace(fn, NULL, status);
+      cp->isEnabled = FALSE;
+      return status;
+    }
+
+    // Skip the segments that were sent entirely, and trim the one that was sent partially.
+    while(n > 0 && sent >= (ssize_t) iov->iov_len) {
+      sent -= iov->iov_len;
+      iov++;
+      n--;
+    }
+
+    if(n > 0) {
+      iov->iov_base = (char *) iov->iov_base + sent;
+      iov->iov_len -= sent;
+    }
+
+#if SEND_YIELD_COUNT > 0
+    if(++count % SEND_YIELD_COUNT == 0) sched_yield();
+#endif
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sends out all data accumulated in the client's coalescing buffer, if any. The caller should have an exclusive
+ * lock on the client. If sending fails, the buffered data is discarded.
+ *
+ * \param cp            Pointer to the private data of the client.
+ * \return              0 if the data was successfully sent (or if there was nothing to send), or else
+ *                      X_NO_SERVICE if there was an error with send().
+ */
+static int rFlushOutAsync(ClientPrivate *cp) {
+  int n = cp->outUsed;
+
+  if(n <= 0) return X_SUCCESS;
+
+  cp->outUsed = 0;
+  prop_error("rFlushOutAsync", rWriteBytesAsync(cp, cp->out, n, TRUE));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sends a sequence of memory segments to the desired socket, either directly, or by appending them to the client's
+ * coalescing buffer, if coalescing is enabled for the client. The coalescing buffer is sent out when it cannot
+ * take more data, or when the client's flusher thread finds that the oldest data in it has been waiting for
+ * longer than the configured delay.
+ *
+ * \param cp            Pointer to the private data of the client.
+ * \param iov           Array of memory segments to send. The array may be modified by the call.
+ * \param n             The number of segments in the array.
+ * \param isLast        TRUE if this is the last component of a longer message, or FALSE
+ *                      if more data will follow imminently.
+ * \return              0 if the data was successfully sent or queued, or X_NO_SERVICE if there was
+ *                      an error with sending.
+ *
+ * @sa rWriteVectorAsync()
+ */
+static int rSendVectorAsync(ClientPrivate *cp, struct iovec *iov, int n, boolean isLast) {
+  static const char *fn = "rSendVectorAsync";
+
+  int i, total = 0;
+
+  if(cp->outSize <= 0) {
+    prop_error(fn, rWriteVectorAsync(cp, iov, n, isLast));
+    return X_SUCCESS;
+  }
+
+  if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client %d: disabled", (int) cp->idx);
+
+  for(i = 0; i < n; i++) total += (int) iov[i].iov_len;
+
+  // Make room, or if it won't fit even then, send the data directly, in order.
+  if(cp->outUsed + total > cp->outSize) {
+    prop_error(fn, rFlushOutAsync(cp));
+    if(total > cp->outSize) {
+      prop_error(fn, rWriteVectorAsync(cp, iov, n, isLast));
+      return X_SUCCESS;
+    }
+  }
+
+  if(cp->outUsed == 0) {
+    // Start the clock on the oldest data in the buffer, and wake the flusher.
+    clock_gettime(CLOCK_REALTIME, &cp->outSince);
+    pthread_cond_signal(&cp->outCond);
+  }
+
+  for(i = 0; i < n; i++) {
+    memcpy(&cp->out[cp->outUsed], iov[i].iov_base, iov[i].iov_len);
+    cp->outUsed += (int) iov[i].iov_len;
+  }
+
+  if(cp->outUsed == cp->outSize) prop_error(fn, rFlushOutAsync(cp));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sends a sequence of bytes to the desired socket, either directly, or via the client's coalescing buffer, if
+ * coalescing is enabled for the client.
+ *
+ * \param cp            Pointer to the private data of the client.
+ * \param buf           Pointer to the buffer containing the data to be sent.
+ * \param length        The number of bytes that should be sent from the buffer.
+ * \param isLast        TRUE if this is the last component of a longer message, or FALSE
+ *                      if more data will follow imminently.
+ * \return              0 if the data was successfully sent or queued, or X_NO_SERVICE if there was
+ *                      an error with sending.
+ *
+ * @sa rSendVectorAsync()
+ */
+static int rSendBytesAsync(ClientPrivate *cp, const char *buf, int length, boolean isLast) {
+  struct iovec iov;
+
+  if(cp->outSize <= 0) return rWriteBytesAsync(cp, buf, length, isLast);
+
+  if(!buf) return x_error(X_NULL, EINVAL, "rSendBytesAsync", "buffer is NULL");
+
+  iov.iov_base = (char *) buf;
+  iov.iov_len = length;
+  return rSendVectorAsync(cp, &iov, 1, isLast);
+}
+
+/**
+ * The flusher thread of a client with write coalescing, which sends out the contents of the coalescing
+ * buffer once the oldest data in it has been waiting for the configured delay. It waits on the client's
+ * write lock, via the client's coalescing condition, so it consumes no CPU while the buffer is empty.
+ *
+ * \param pClient   Pointer to the Redis client
+ * \return          Always NULL.
+ */
+static void *RedisFlusher(void *pClient) {
+  RedisClient *cl = (RedisClient *) pClient;
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+
+  xvprintf("Redis-X> Started flusher for client %d.\n", (int) cp->idx);
+
+  pthread_mutex_lock(&cp->writeLock);
+
+  while(!cp->stopFlusher) {
+    struct timespec deadline, now;
+
+    if(cp->outUsed <= 0) {
+      pthread_cond_wait(&cp->outCond, &cp->writeLock);
+      continue;
+    }
+
+    deadline = cp->outSince;
+    deadline.tv_nsec += cp->outDelayMicros * 1000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    if(now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+      rFlushOutAsync(cp);
+    }
+    else pthread_cond_timedwait(&cp->outCond, &cp->writeLock, &deadline);
+  }
+
+  rFlushOutAsync(cp);
+
+  pthread_mutex_unlock(&cp->writeLock);
+
+  xvprintf("Redis-X> Stopped flusher for client %d.\n", (int) cp->idx);
+
+  return NULL;
+}
+
+/// \endcond
+
+/**
+ * Sends out any requests that are waiting in the coalescing buffer of a client. It should be called with an
+ * exclusive lock on the client. It is a no-op for clients that do not coalesce writes.
+ *
+ * \param cl            Pointer to the Redis client.
+ * \return              X_SUCCESS (0) if successful, or else X_NULL if the client is NULL, X_NO_INIT if
+ *                      the client was not initialized, or X_NO_SERVICE if the data could not be sent.
+ *
+ * @sa redisxSetPipelineCoalescing()
+ */
+int redisxFlushAsync(RedisClient *cl) {
+  static const char *fn = "redisxFlushAsync";
+
+  prop_error(fn, rCheckClient(cl));
+  prop_error(fn, rFlushOutAsync((ClientPrivate *) cl->priv));
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Enables, reconfigures, or disables write coalescing for a client, starting or stopping the client's
+ * flusher thread as necessary. It should not be called with the client's lock held.
+ *
+ * \param cl            Pointer to the Redis client.
+ * \param size          (bytes) Size of the coalescing buffer, or &lt;=0 to disable coalescing.
+ * \param delayMicros   [us] Maximum time requests may wait in the buffer before they are sent.
+ * \return              X_SUCCESS (0) if successful, or else X_FAILURE if the buffer could not be
+ *                      allocated or the flusher thread could not be started.
+ */
+int rSetCoalescing(RedisClient *cl, int size, int delayMicros) {
+  static const char *fn = "rSetCoalescing";
+
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  int status = X_SUCCESS;
+
+  pthread_mutex_lock(&cp->writeLock);
+
+  // Send what we have with the old settings first.
+  rFlushOutAsync(cp);
+
+  if(size > 0) {
+    char *out = (char *) realloc(cp->out, size);
+    if(!out) status = x_error(X_FAILURE, errno, fn, "alloc error (%d bytes)", size);
+    else {
+      cp->out = out;
+      cp->outSize = size;
+      cp->outDelayMicros = delayMicros > 0 ? delayMicros : REDISX_COALESCE_DELAY_MICROS;
+      cp->stopFlusher = FALSE;
+
+      if(!cp->hasFlusher) {
+        if(pthread_create(&cp->flusherTID, NULL, RedisFlusher, cl) == 0) cp->hasFlusher = TRUE;
+        else {
+          cp->outSize = 0;
+          status = x_error(X_FAILURE, errno, fn, "pthread_create: %s", strerror(errno));
+        }
+      }
+    }
+  }
+  else cp->outSize = 0;
+
+  if(cp->outSize <= 0 && cp->hasFlusher) {
+    pthread_t tid = cp->flusherTID;
+
+    cp->stopFlusher = TRUE;
+    cp->hasFlusher = FALSE;
+    pthread_cond_signal(&cp->outCond);
+    pthread_mutex_unlock(&cp->writeLock);
+
+    pthread_join(tid, NULL);
+    return status;
+  }
+
+  pthread_mutex_unlock(&cp->writeLock);
+
+  return status;
+}
+
+/// \endcond
+
+/**
+ * Adds a (non-empty) memory segment to a list of segments to send via rSendVectorAsync().
+ *
+ * \param iov           Array of memory segments.
+ * \param k             Pointer to the number of segments in the array, which is incremented if the segment is added.
+ * \param data          Start of the memory segment to add.
+ * \param length        (bytes) Length of the segment. Empty segments are ignored.
+ */
+static void rAddSegment(struct iovec *iov, int *k, const char *data, int length) {
+  if(length <= 0) return;
+  iov[*k].iov_base = (void *) data;
+  iov[*k].iov_len = length;
+  (*k)++;
+}
+
 /// \endcond
 
 /**
@@ -375,11 +750,109 @@ RedisClient *redisxGetClient(Redis *redis, enum redisx_channel channel) {
  * @sa redisxLockConnected()
  */
 RedisClient *redisxGetLockedConnectedClient(Redis *redis, enum redisx_channel channel) {
-  RedisClient *cl = redisxGetClient(redis, channel);
-  if(redisxLockConnected(cl) != X_SUCCESS) return x_trace_null("redisxGetLockedConnectedClient", NULL);
+  RedisClient *cl;
+
+  if(channel == REDISX_INTERACTIVE_CHANNEL) cl = rLockInteractive(redis, NULL);
+  else {
+    cl = redisxGetClient(redis, channel);
+    if(redisxLockConnected(cl) != X_SUCCESS) cl = NULL;
+  }
+
+  if(!cl) return x_trace_null("redisxGetLockedConnectedClient", NULL);
+  return cl;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Tries to get the exclusive lock on a connected client, without waiting for it.
+ *
+ * \param cl    Pointer to a Redis client
+ * \return      TRUE (1) if the client is connected and we got the lock on it, or else FALSE (0).
+ */
+static boolean rTryLockConnected(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+
+  if(!cp || !cp->isEnabled) return FALSE;
+  if(pthread_mutex_trylock(&cp->writeLock) != 0) return FALSE;
+
+  if(!cp->isEnabled) {
+    pthread_mutex_unlock(&cp->writeLock);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * Returns a free interactive client of a Redis instance with an exclusive lock, without waiting for a busy one.
+ * Unlike rLockInteractive(), it may be called while holding locks that the users of the clients may need.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \return              The locked interactive client, or NULL if none of the clients is both connected and free.
+ */
+RedisClient *rTryLockInteractive(Redis *redis) {
+  const RedisPrivate *p = (RedisPrivate *) redis->priv;
+  int i;
+
+  if(rTryLockConnected(redis->interactive)) return redis->interactive;
+  for(i = 0; i < p->poolSize; i++) if(rTryLockConnected(&p->pool[i])) return &p->pool[i];
+
+  return NULL;
+}
+
+/**
+ * Returns an interactive client of a Redis instance with an exclusive lock, using a free client from the pool of
+ * interactive connections, if possible (see redisxSetInteractivePoolSize()). If all connected clients are busy, it
+ * waits for one of them, taking turns between the clients of the pool.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param[out] pStatus  (optional) Pointer to int in which to return an error status, if no client could be
+ *                      obtained. It may be NULL if not required.
+ * \return              The locked interactive client, or NULL if the Redis instance is not connected.
+ */
+RedisClient *rLockInteractive(Redis *redis, int *pStatus) {
+  static const char *fn = "rLockInteractive";
+
+  RedisPrivate *p;
+  RedisClient *cl;
+  int i, status;
+
+  status = redisxCheckValid(redis);
+  if(status) {
+    if(pStatus) *pStatus = status;
+    return x_trace_null(fn, NULL);
+  }
+
+  p = (RedisPrivate *) redis->priv;
+
+  if(p->poolSize > 0) {
+    // Use the first free client, if any.
+    cl = rTryLockInteractive(redis);
+    if(cl) return cl;
+
+    // Take turns waiting on the connected clients
+    rConfigLock(redis);
+    i = p->poolNext;
+    p->poolNext = (i + 1) % (p->poolSize + 1);
+    rConfigUnlock(redis);
+
+    cl = i > 0 ? &p->pool[i - 1] : redis->interactive;
+    if(redisxLockConnected(cl) == X_SUCCESS) return cl;
+  }
+
+  cl = redis->interactive;
+  status = redisxLockConnected(cl);
+  if(status) {
+    if(pStatus) *pStatus = status;
+    return x_trace_null(fn, NULL);
+  }
+
   return cl;
 }
 
+/// \endcond
+
 /**
  * Get exclusive write access to the specified Redis channel.
  *
@@ -466,12 +939,152 @@ int redisxUnlockClient(RedisClient *cl) {
   return X_SUCCESS;
 }
 
+/// \cond PRIVATE
+
+/**
+ * Accounts for a request that was just sent on a client: unless its reply was skipped, or replies are turned
+ * off altogether, a reply is expected for it. It should be called with an exclusive lock on the client, after
+ * each request that Redis may reply to.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ */
+static void rCountRequestAsync(ClientPrivate *cp) {
+  pthread_mutex_lock(&cp->pendingLock);
+  if(cp->skipNext) cp->skipNext = FALSE;
+  else if(!cp->noReply) {
+    cp->pendingRequests++;
+    cp->requestSeq++;
+  }
+  pthread_mutex_unlock(&cp->pendingLock);
+}
+
+/**
+ * Sends a pre-formatted request (such as <code>MULTI</code> or <code>EXEC</code>) on a client, accounting
+ * for its reply the same way as for requests sent via redisxSendArrayRequestAsync(). It should be called with
+ * an exclusive lock on the client.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param cmd       The RESP-formatted request.
+ * \param length    The number of bytes in the request.
+ * \return          X_SUCCESS (0) if successful, or else an error code &lt;0 from rSendBytesAsync().
+ */
+static int rSendCommandAsync(ClientPrivate *cp, const char *cmd, int length) {
+  prop_error("rSendCommandAsync", rSendBytesAsync(cp, cmd, length, !cp->noReply));
+  rCountRequestAsync(cp);
+  return X_SUCCESS;
+}
+
+/**
+ * Queues a completion for the next request to be sent on a client. It should be called with an exclusive lock
+ * on the client, just before sending the request.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param f         The function to call with the reply.
+ * \param arg       User data pointer to pass along to the callback.
+ * \return          The new completion.
+ */
+static RedisCompletion *rAddCompletion(ClientPrivate *cp, RedisReplyCallback f, void *arg) {
+  RedisCompletion *c = (RedisCompletion *) calloc(1, sizeof(RedisCompletion));
+  x_check_alloc(c);
+
+  c->call = f;
+  c->arg = arg;
+
+  // Queue up the completion before sending, so the reply will find it...
+  pthread_mutex_lock(&cp->pendingLock);
+  c->seq = cp->requestSeq + 1;
+  if(cp->lastCompletion) cp->lastCompletion->next = c;
+  else cp->firstCompletion = c;
+  cp->lastCompletion = c;
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  return c;
+}
+
+/**
+ * Removes a completion, whose request could not be sent, unless the client was reset already, which has
+ * discarded it.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param c         The completion to remove.
+ */
+static void rRemoveCompletion(ClientPrivate *cp, RedisCompletion *c) {
+  RedisCompletion *prev = NULL, *e;
+
+  pthread_mutex_lock(&cp->pendingLock);
+  for(e = cp->firstCompletion; e; prev = e, e = e->next) if(e == c) {
+    if(prev) prev->next = c->next;
+    else cp->firstCompletion = c->next;
+    if(cp->lastCompletion == c) cp->lastCompletion = prev;
+    free(c);
+    break;
+  }
+  pthread_mutex_unlock(&cp->pendingLock);
+}
+
+/**
+ * Marks the reply to the next request to be sent on a client for discarding, as soon as it is read. The reply
+ * is identified by the number of other replies still due before it, rather than by its sequence number, so it
+ * is dropped even if the request / reply counters of the client are out of step. It should be called with an
+ * exclusive lock on the client, just before sending the request.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \return          The new discard entry.
+ */
+static RedisDiscard *rAddDiscard(ClientPrivate *cp) {
+  RedisDiscard *d = (RedisDiscard *) calloc(1, sizeof(RedisDiscard));
+  const RedisDiscard *e;
+  int ahead;
+
+  x_check_alloc(d);
+
+  pthread_mutex_lock(&cp->pendingLock);
+
+  // Replies due before this one, not counting those before (and of) other discards in the queue.
+  ahead = cp->pendingRequests;
+  for(e = cp->firstDiscard; e; e = e->next) ahead -= e->ahead + 1;
+  d->ahead = ahead > 0 ? ahead : 0;
+
+  if(cp->lastDiscard) cp->lastDiscard->next = d;
+  else cp->firstDiscard = d;
+  cp->lastDiscard = d;
+
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  return d;
+}
+
+/**
+ * Removes a discard entry, whose request could not be sent, unless the client was reset already, which has
+ * discarded it.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param d         The discard entry to remove.
+ */
+static void rRemoveDiscard(ClientPrivate *cp, RedisDiscard *d) {
+  RedisDiscard *prev = NULL, *e;
+
+  pthread_mutex_lock(&cp->pendingLock);
+  for(e = cp->firstDiscard; e; prev = e, e = e->next) if(e == d) {
+    if(prev) prev->next = d->next;
+    else cp->firstDiscard = d->next;
+    if(cp->lastDiscard == d) cp->lastDiscard = prev;
+    free(d);
+    break;
+  }
+  pthread_mutex_unlock(&cp->pendingLock);
+}
+
+/// \endcond
+
 /**
  * Instructs Redis to skip sending a reply for the next command. This function should be called
  * with an exclusive lock on a connected client, and just before redisxSendRequest() or
  * redisxSendArrayRequestAsync().
  *
- * Sends <code>CLIENT REPLY SKIP</code>
+ * Sends <code>CLIENT REPLY SKIP</code>, together with the next request, rather than on its own. It does nothing
+ * while replies are turned off for the client altogether (see redisxStartNoReplyAsync()), in which case the
+ * next request costs just itself.
  *
  * \param cl            Pointer to the Redis client to use.
  *
@@ -487,8 +1100,112 @@ int redisxSkipReplyAsync(RedisClient *cl) {
   static const char *fn = "redisSkipReplyAsync";
   static const char cmd[] = "*3\r\n$6\r\nCLIENT\r\n$5\r\nREPLY\r\n$4\r\nSKIP\r\n";
 
+  ClientPrivate *cp;
+
+  prop_error(fn, rCheckClient(cl));
+
+  cp = (ClientPrivate *) cl->priv;
+
+  // No replies are sent at all, so nothing to skip.
+  if(cp->noReply) return X_SUCCESS;
+
+  // Send it along with the request that follows.
+  prop_error(fn, rSendBytesAsync(cp, cmd, sizeof(cmd) - 1, FALSE));
+
+  // The next request will not have a reply
+  pthread_mutex_lock(&cp->pendingLock);
+  cp->skipNext = TRUE;
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Turns off replies for all subsequent requests on a client, by sending <code>CLIENT REPLY OFF</code>, until
+ * redisxEndNoReplyAsync() is called. It is meant for sending a batch of writes, for which no confirmation is
+ * needed, at the cost of a single command each, rather than with a <code>CLIENT REPLY SKIP</code> ahead of each.
+ * While replies are off, the requests are handed to the kernel as more data to follow, so that they are
+ * coalesced into as few packets as possible, and pushed out when replies are turned back on. It should be
+ * called with an exclusive lock on a connected client, which should be held until replies are turned back on.
+ *
+ * For example:
+ *
+ * ```c
+ *   redisxLockConnected(cl);
+ *   redisxStartNoReplyAsync(cl);
+ *   for(i = 0; i < n; i++) redisxSetValueAsync(cl, table, keys[i], values[i], FALSE);
+ *   redisxEndNoReplyAsync(cl);
+ *   redisxUnlockClient(cl);
+ * ```
+ *
+ * \param cl            Pointer to the Redis client to use.
+ *
+ * \return              X_SUCCESS (0) on success or X_NULL if the client is NULL, or else X_NO_SERVICE
+ *                      if not connected to the Redis server on the requested channel, or if send()
+ *                      failed, or else X_NO_INIT if the client was not initialized.
+ *
+ * @sa redisxEndNoReplyAsync()
+ * @sa redisxSkipReplyAsync()
+ */
+int redisxStartNoReplyAsync(RedisClient *cl) {
+  static const char *fn = "redisxStartNoReplyAsync";
+  static const char cmd[] = "*3\r\n$6\r\nCLIENT\r\n$5\r\nREPLY\r\n$3\r\nOFF\r\n";
+
+  ClientPrivate *cp;
+
+  prop_error(fn, rCheckClient(cl));
+
+  cp = (ClientPrivate *) cl->priv;
+  if(cp->noReply) return X_SUCCESS;
+
+  prop_error(fn, rSendBytesAsync(cp, cmd, sizeof(cmd) - 1, FALSE));
+
+  pthread_mutex_lock(&cp->pendingLock);
+  cp->noReply = TRUE;
+  cp->skipNext = FALSE;
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Turns replies back on for a client, after redisxStartNoReplyAsync(), by sending <code>CLIENT REPLY ON</code>,
+ * and pushes out the requests that were sent while replies were turned off. The <code>OK</code> that Redis
+ * sends in response is discarded automatically, so the caller need not read it. It should be called with an
+ * exclusive lock on a connected client.
+ *
+ * \param cl            Pointer to the Redis client to use.
+ *
+ * \return              X_SUCCESS (0) on success or X_NULL if the client is NULL, or else X_NO_SERVICE
+ *                      if not connected to the Redis server on the requested channel, or if send()
+ *                      failed, or else X_NO_INIT if the client was not initialized.
+ *
+ * @sa redisxStartNoReplyAsync()
+ */
+int redisxEndNoReplyAsync(RedisClient *cl) {
+  static const char *fn = "redisxEndNoReplyAsync";
+  static const char *cmd[] = { "CLIENT", "REPLY", "ON" };
+
+  ClientPrivate *cp;
+  RedisDiscard *d;
+  int status;
+
   prop_error(fn, rCheckClient(cl));
-  prop_error(fn, rSendBytesAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1, TRUE));
+
+  cp = (ClientPrivate *) cl->priv;
+  if(!cp->noReply) return X_SUCCESS;
+
+  pthread_mutex_lock(&cp->pendingLock);
+  cp->noReply = FALSE;
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  // The reply to 'CLIENT REPLY ON' is to be discarded by whoever reads it.
+  d = rAddDiscard(cp);
+
+  status = redisxSendArrayRequestAsync(cl, cmd, NULL, 3);
+  if(status) rRemoveDiscard(cp, d);
+
+  prop_error(fn, status);
 
   return X_SUCCESS;
 }
@@ -521,7 +1238,7 @@ int redisxStartBlockAsync(RedisClient *cl) {
   static const char cmd[] = "*1\r\n$5\r\nMULTI\r\n";
 
   prop_error(fn, rCheckClient(cl));
-  prop_error(fn, rSendBytesAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1, TRUE));
+  prop_error(fn, rSendCommandAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1));
 
   return X_SUCCESS;
 }
@@ -544,7 +1261,10 @@ int redisxAbortBlockAsync(RedisClient *cl) {
   static const char cmd[] = "*1\r\n$7\r\nDISCARD\r\n";
 
   prop_error(fn, rCheckClient(cl));
-  prop_error(fn, rSendBytesAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1, TRUE));
+  prop_error(fn, rSendCommandAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1));
+
+  // Don't leave the request waiting in the coalescing buffer while we wait for its reply.
+  prop_error(fn, rFlushOutAsync((ClientPrivate *) cl->priv));
 
   redisxIgnoreReplyAsync(cl);
 
@@ -578,13 +1298,11 @@ RESP *redisxExecBlockAsync(RedisClient *cl, int *pStatus) {
     return NULL;
   }
 
-  status = redisxSkipReplyAsync(cl);
-  if(status) {
-    if(pStatus) *pStatus = status;
-    return x_trace_null(fn, NULL);
-  }
+  // All replies in the block, up to and including that of EXEC, are read below, so none are skipped.
+  status = rSendCommandAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1);
 
-  status = rSendBytesAsync((ClientPrivate *) cl->priv, cmd, sizeof(cmd) - 1, TRUE);
+  // Don't leave the block waiting in the coalescing buffer while we wait for its reply.
+  if(!status) status = rFlushOutAsync((ClientPrivate *) cl->priv);
   if(status) {
     if(pStatus) *pStatus = status;
     return x_trace_null(fn, NULL);
@@ -684,8 +1402,9 @@ int redisxSendRequestAsync(RedisClient *cl, const char *command, const char *arg
  */
 int redisxSendArrayRequestAsync(RedisClient *cl, const char **args, const int *lengths, int n) {
   static const char *fn = "redisxSendArrayRequestAsync";
-  char buf[REDISX_CMDBUF_SIZE];
-  int i, L;
+  char buf[REDISX_CMDBUF_SIZE];           // Staging buffer for headers and short arguments
+  struct iovec iov[SEND_IOV_COUNT];       // Segments to send, from buf and/or the arguments themselves.
+  int i, L, from = 0, k = 0, inlineSize;
   ClientPrivate *cp;
 
   prop_error(fn, rCheckClient(cl));
@@ -693,6 +1412,13 @@ int redisxSendArrayRequestAsync(RedisClient *cl, const char **args, const int *l
   cp = (ClientPrivate *) cl->priv;
   if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client is not connected");
 
+  // Without a vectored write for TLS, we are better off copying everything we can into the buffer.
+#if WITH_TLS
+  inlineSize = cp->ssl ? REDISX_CMDBUF_SIZE : SEND_INLINE_SIZE;
+#else
+  inlineSize = SEND_INLINE_SIZE;
+#endif
+
   // Send the number of string elements in the command...
   L = sprintf(buf, "*%d\r\n", n);
 
@@ -706,53 +1432,275 @@ int redisxSendArrayRequestAsync(RedisClient *cl, const char **args, const int *l
   xvprintf("\n");
 
   for(i = 0; i < n; i++) {
-    int l, L1;
+    int l;
+    boolean isInline;
 
     if(!args[i]) l = 0; // Check for potential NULL parameters...
     else if(lengths) l = lengths[i] > 0 ? lengths[i] : (int) strlen(args[i]);
     else l = (int) strlen(args[i]);
 
+    isInline = (l + 16 <= inlineSize);
+
+    // Flush what we have if the buffer or the segment list cannot take the next argument...
+    // ($<length>\r\n takes up to 14 bytes, with room for the trailing \r\n).
+    if(L + 16 + (isInline ? l : 0) > REDISX_CMDBUF_SIZE || k + 3 > SEND_IOV_COUNT) {
+      rAddSegment(iov, &k, buf + from, L - from);
+      prop_error(fn, rSendVectorAsync(cp, iov, k, FALSE));
+      L = from = k = 0;
+    }
 
     L += sprintf(buf + L, "$%d\r\n", l);
 
-    // length of next RESP the bulk string component including \r\n\0 termination.
-    L1 = l + 3;
+    if(isInline) {
+      if(l > 0) memcpy(buf + L, args[i], l);            // Copy argument into buffer.
+      L += l;
+    }
+    else {
+      // Send long arguments from where they are, without copying.
+      rAddSegment(iov, &k, buf + from, L - from);
+      rAddSegment(iov, &k, args[i], l);
+      from = L;
+    }
 
-    if((L + L1) > REDISX_CMDBUF_SIZE) {
-      // If buf cannot include the next argument, then flush the buffer...
-      prop_error(fn, rSendBytesAsync(cp, buf, L, FALSE));
+    buf[L++] = '\r';
+    buf[L++] = '\n';
+  }
 
-      L = 0;
+  // flush the remaining bits (or hold on to them, if no one is waiting for a reply)...
+  rAddSegment(iov, &k, buf + from, L - from);
+  prop_error(fn, rSendVectorAsync(cp, iov, k, !cp->noReply));
+  rCountRequestAsync(cp);
 
-      // If the next argument does not fit into the buffer, then send it piecemeal
-      if(L1 > REDISX_CMDBUF_SIZE) {
-        prop_error(fn, rSendBytesAsync(cp, args[i], l, FALSE));
-        prop_error(fn, rSendBytesAsync(cp, "\r\n", 2, i == (n-1)));
-      }
-      else {
-        if(l > 0) memcpy(buf, args[i], l);            // Copy argument into buffer.
-        L = l + sprintf(buf+l, "\r\n");     // Add \r\n\0...
-      }
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Sends a request whose last argument is assembled from several memory segments, which are sent from where they
+ * are, without copying or concatenating them first. The caller should have an exclusive lock on the client.
+ *
+ * \param cl            Pointer to a Redis client.
+ * \param args          The leading string arguments of the request (e.g. command and channel), up to 8.
+ * \param n             The number of leading string arguments.
+ * \param parts         The memory segments of the last argument.
+ * \param nParts        The number of memory segments in the last argument.
+ *
+ * \return              X_SUCCESS (0) if successful, or else an error code &lt;0 (see redisxSendArrayRequestAsync()).
+ *
+ * @sa redisxSendArrayRequestAsync()
+ */
+int rSendScatterRequestAsync(RedisClient *cl, const char **args, int n, const struct iovec *parts, int nParts) {
+  static const char *fn = "rSendScatterRequestAsync";
+  char buf[REDISX_CMDBUF_SIZE];           // Staging buffer for the headers
+  struct iovec iov[SEND_IOV_COUNT];       // Segments to send, from buf and from the arguments themselves.
+  long long total = 0;
+  int i, L, from = 0, k = 0;
+  ClientPrivate *cp;
+
+  prop_error(fn, rCheckClient(cl));
+
+  if(n < 0 || 3 * n + 2 > SEND_IOV_COUNT) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of arguments: %d", n);
+  if(nParts < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of parts: %d", nParts);
+  if(nParts > 0 && !parts) return x_error(X_NULL, EINVAL, fn, "parts is NULL");
+
+  for(i = 0; i < nParts; i++) total += parts[i].iov_len;
+  if(total > INT_MAX) return x_error(X_SIZE_INVALID, EINVAL, fn, "argument too large: %lld bytes", total);
+
+  cp = (ClientPrivate *) cl->priv;
+  if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, fn, "client is not connected");
+
+  L = sprintf(buf, "*%d\r\n", n + 1);
+
+  for(i = 0; i < n; i++) {
+    int l = args[i] ? (int) strlen(args[i]) : 0;
+
+    L += sprintf(buf + L, "$%d\r\n", l);
+    rAddSegment(iov, &k, buf + from, L - from);
+    if(l > 0) rAddSegment(iov, &k, args[i], l);
+    from = L;
+
+    buf[L++] = '\r';
+    buf[L++] = '\n';
+  }
+
+  L += sprintf(buf + L, "$%d\r\n", (int) total);
+  rAddSegment(iov, &k, buf + from, L - from);
+  from = L;
+
+  // The trailing \r\n, to send after the parts.
+  buf[L++] = '\r';
+  buf[L++] = '\n';
+
+  for(i = 0; i < nParts; i++) {
+    if(k >= SEND_IOV_COUNT) {
+      prop_error(fn, rSendVectorAsync(cp, iov, k, FALSE));
+      k = 0;
     }
-    else {
-      if(l > 0) memcpy(buf+L, args[i], l);            // Copy argument into buffer.
-      L += l;
-      L += sprintf(buf+L, "\r\n");          // Add \r\n\0
+    rAddSegment(iov, &k, (const char *) parts[i].iov_base, (int) parts[i].iov_len);
+  }
+
+  if(k >= SEND_IOV_COUNT) {
+    prop_error(fn, rSendVectorAsync(cp, iov, k, FALSE));
+    k = 0;
+  }
+
+  rAddSegment(iov, &k, buf + from, L - from);
+  prop_error(fn, rSendVectorAsync(cp, iov, k, !cp->noReply));
+  rCountRequestAsync(cp);
+
+  return X_SUCCESS;
+}
+
+/// \endcond
+
+/**
+ * Sends a request on the pipeline client of a Redis instance, with a dedicated function to call with the reply
+ * to this request. Unlike the pipeline consumer set by redisxSetPipelineConsumer(), which sees all pipeline
+ * responses without knowing which request each belongs to, the callback receives only the reply to this
+ * request, together with the user data supplied here. The callbacks are called by the pipeline listener, in
+ * the same order as the requests were sent. Replies to requests that have a callback are not passed to the
+ * pipeline consumer.
+ *
+ * You may mix callback-based requests with other requests sent on the pipeline client, including requests
+ * whose reply is skipped via redisxSkipReplyAsync(). However, you should not read replies from the pipeline
+ * client directly.
+ *
+ * \param redis         Pointer to a Redis instance, connected with the pipeline enabled.
+ * \param args          The array of string arguments to send.
+ * \param lengths       Array indicating the number of bytes to send from each string argument, or NULL to
+ *                      use strlen() for all arguments (see redisxSendArrayRequestAsync()).
+ * \param n             The number of arguments to send.
+ * \param f             The function to call with the reply. It is called with a NULL reply if the request is
+ *                      not answered because the pipeline client was closed.
+ * \param userData      User data pointer to pass along to the callback.
+ *
+ * \return              X_SUCCESS (0) if the request was sent, or else X_NULL if the Redis instance or the
+ *                      callback function is NULL, X_NO_SERVICE if the pipeline is not connected or if the
+ *                      request could not be sent, or X_NO_INIT if the Redis instance was not initialized.
+ *                      If the request was not sent, the callback will not be called.
+ *
+ * @sa redisxSendArrayRequestAsync()
+ * @sa redisxSetPipelineConsumer()
+ */
+int redisxSendRequestCb(Redis *redis, const char **args, const int *lengths, int n, RedisReplyCallback f, void *userData) {
+  static const char *fn = "redisxSendRequestCb";
+
+  RedisClient *cl;
+  ClientPrivate *cp;
+  RedisCompletion *c;
+  int status;
+
+  prop_error(fn, redisxCheckValid(redis));
+  if(!f) return x_error(X_NULL, EINVAL, fn, "callback function is NULL");
+
+  cl = redisxGetLockedConnectedClient(redis, REDISX_PIPELINE_CHANNEL);
+  if(!cl) return x_trace(fn, NULL, X_NO_SERVICE);
+
+  cp = (ClientPrivate *) cl->priv;
+
+  c = rAddCompletion(cp, f, userData);
+
+  status = redisxSendArrayRequestAsync(cl, args, lengths, n);
+  if(status) rRemoveCompletion(cp, c);
+
+  redisxUnlockClient(cl);
+
+  prop_error(fn, status);
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Calls the callback of the pipelined request, which the specified reply answers, if the request was
+ * sent via redisxSendRequestCb(). It should be called by the (single) consumer of the client's replies,
+ * right after the reply was read.
+ *
+ * \param cl        Pointer to a Redis client.
+ * \param reply     The reply that was received last on the client.
+ * \return          TRUE (1) if the reply was passed to a request-specific callback, or else FALSE (0).
+ */
+boolean rCompleteRequestAsync(RedisClient *cl, RESP *reply) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  RedisCompletion *c = NULL, *stale = NULL;
+
+  pthread_mutex_lock(&cp->pendingLock);
+
+  // Completions whose replies were consumed elsewhere (should not happen)...
+  if(cp->firstCompletion && cp->firstCompletion->seq < cp->replySeq) {
+    stale = cp->firstCompletion;
+    while(cp->firstCompletion && cp->firstCompletion->seq < cp->replySeq) {
+      c = cp->firstCompletion;
+      cp->firstCompletion = c->next;
     }
+    c->next = NULL;
+    c = NULL;
   }
 
-  // flush the remaining bits in the buffer...
-  if(L > 0) {
-    prop_error(fn, rSendBytesAsync(cp, buf, L, TRUE));
+  if(cp->firstCompletion && cp->firstCompletion->seq == cp->replySeq) {
+    c = cp->firstCompletion;
+    cp->firstCompletion = c->next;
   }
 
+  if(!cp->firstCompletion) cp->lastCompletion = NULL;
+
+  pthread_mutex_unlock(&cp->pendingLock);
+
+  while(stale) {
+    RedisCompletion *next = stale->next;
+    x_warn("RedisX", "pipeline reply for request #%llu went missing.\n", (unsigned long long) stale->seq);
+    stale->call(NULL, stale->arg);
+    free(stale);
+    stale = next;
+  }
+
+  if(!c) return FALSE;
+
+  c->call(reply, c->arg);
+  free(c);
+
+  return TRUE;
+}
+
+/**
+ * Discards all pending completions of a client, calling their callbacks with a NULL reply, and resets the
+ * request / reply counters of the client. It is called when the client is reset, since the replies to prior
+ * requests will not arrive after that.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ */
+void rCancelRequestsAsync(ClientPrivate *cp) {
+  RedisCompletion *c;
+  RedisDiscard *d;
+
   pthread_mutex_lock(&cp->pendingLock);
-  cp->pendingRequests++;
+  c = cp->firstCompletion;
+  cp->firstCompletion = cp->lastCompletion = NULL;
+  d = cp->firstDiscard;
+  cp->firstDiscard = cp->lastDiscard = NULL;
+  cp->requestSeq = cp->replySeq = 0;
+  cp->skipNext = FALSE;
+  cp->noReply = FALSE;
   pthread_mutex_unlock(&cp->pendingLock);
 
-  return X_SUCCESS;
+  while(c) {
+    RedisCompletion *next = c->next;
+    c->call(NULL, c->arg);
+    free(c);
+    c = next;
+  }
+
+  while(d) {
+    RedisDiscard *next = d->next;
+    free(d);
+    d = next;
+  }
 }
 
+/// \endcond
+
 /**
  * Silently consumes a reply from the specified Redis channel. This function should be called
  * with an exclusive lock on a connected client.
@@ -779,6 +1727,46 @@ int redisxIgnoreReplyAsync(RedisClient *cl) {
   return status;
 }
 
+/**
+ * Allocates storage for a reply, either from an arena, or else from the heap.
+ *
+ * @param arena     The arena to allocate from, or NULL to use malloc().
+ * @param size      (bytes) The amount of storage needed
+ * @return          Pointer to the storage, or NULL if there was an allocation error.
+ */
+static void *rMalloc(RedisArena *arena, size_t size) {
+  return arena ? rArenaAlloc(arena, size) : malloc(size);
+}
+
+/**
+ * Allocates zeroed storage for a reply, either from an arena, or else from the heap.
+ *
+ * @param arena     The arena to allocate from, or NULL to use calloc().
+ * @param count     Number of elements
+ * @param size      (bytes) The size of each element
+ * @return          Pointer to the storage, or NULL if there was an allocation error.
+ */
+static void *rCalloc(RedisArena *arena, size_t count, size_t size) {
+  void *ptr;
+
+  if(!arena) return calloc(count, size);
+
+  ptr = rArenaAlloc(arena, count * size);
+  if(ptr) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+/**
+ * Destroys a RESP allocated from the heap. RESPs allocated from an arena are left alone, since they are
+ * freed together with the arena.
+ *
+ * @param arena     The arena from which the RESP was allocated, or NULL if it was allocated on the heap.
+ * @param resp      The RESP to destroy.
+ */
+static void rDestroyRESP(const RedisArena *arena, RESP *resp) {
+  if(!arena) redisxDestroyRESP(resp);
+}
+
 static int rTypeIsParametrized(char type) {
   switch(type) {
     case RESP_INT:
@@ -799,6 +1787,8 @@ static int rTypeIsParametrized(char type) {
 
 
 
+static RESP *rReadReplyAsync(RedisClient *cl, RedisArena *arena, char *dst, int dstSize, int *pStatus);
+
 static void rPushMessageAsync(RedisClient *cl, RESP *resp) {
   int i;
   ClientPrivate *cp = (ClientPrivate *) cl->priv;
@@ -814,7 +1804,7 @@ static void rPushMessageAsync(RedisClient *cl, RESP *resp) {
 
   for(i = 0; i < resp->n; i++) {
     int status = X_SUCCESS;
-    RESP *r = redisxReadReplyAsync(cl, &status);
+    RESP *r = rReadReplyAsync(cl, NULL, NULL, 0, &status);
     if(status) {
       redisxDestroyRESP(resp);
       x_trace_null("rPushMessageAsync", NULL);
@@ -824,7 +1814,12 @@ static void rPushMessageAsync(RedisClient *cl, RESP *resp) {
     else redisxDestroyRESP(r);
   }
 
-  if(p->config.pushConsumer) p->config.pushConsumer(cl, resp, p->config.pushArg);
+  if(p->config.pushConsumer) {
+    // Do not hold up other readers while the consumer processes the message.
+    pthread_mutex_unlock(&cp->readLock);
+    p->config.pushConsumer(cl, resp, p->config.pushArg);
+    pthread_mutex_lock(&cp->readLock);
+  }
 
   redisxDestroyRESP(resp);
 }
@@ -941,64 +1936,39 @@ int redisxGetAvailable(RedisClient *cl) {
 }
 
 /**
- * Reads a response from Redis and returns it. It should be used with an exclusive lock on a connected
- * client, to collect responses for requests sent previously. It is up to the caller to keep track of
- * what request the response is for. The responses arrive in the same order (and same nummber) as
- * the requests that were sent out.
- *
- * To follow cluster MOVED or ASK redirections, the caller should check the reponse for redirections
- * (e.g. via redisxIsRedirected()) and then act accordingly to re-submit the corresponding request,
- * as is or with an ASKING directive to follow the redirection.
+ * Reads a single (possibly nested) RESP element from the client. The caller must hold the read lock
+ * of the client.
  *
  * \param cl         Pointer to a Redis channel
+ * \param arena      (optional) Arena from which to allocate the reply and its components, or NULL to
+ *                   allocate them on the heap. Push messages and attributes are always allocated on the heap.
+ * \param dst        (optional) Buffer into which to read a bulk string reply directly, or NULL to allocate
+ *                   storage for it as usual. If used, the value of the returned RESP is NULL.
+ * \param dstSize    (bytes) Size of the dst buffer. The remainder of longer bulk strings is discarded.
  * \param pStatus    Pointer to int in which to return an error status, or NULL if not required.
  *
- * \return      The RESP structure for the reponse received from Redis, or NULL if an error was encountered
- *              (errno will be set to describe the error, which may either be an errno produced by recv()
- *              or EBADMSG if the message was corrupted and/or unparseable. If the error is irrecoverable
- *              i.e., other than a timeout, the client will be disabled.)
- *
- * @sa redisxIgnoreReplyAsync()
- * @sa redisxSetReplyTimeout()
- * @sa redisxGetAvailableAsync()
- * @sa redisxSendRequestAsync()
- * @sa redisxSendArrayRequestAsync()
- * @sa redisxGetLockedConnected()
- * @sa redisxCheckRESP()
- * @sa redisxIsRedirected()
+ * \return      The RESP structure for the reponse received from Redis, or NULL if an error was encountered.
+ *              If the error is irrecoverable, the client is marked disabled, and the caller should close it
+ *              after releasing the read lock.
  */
-RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
+static RESP *rReadReplyAsync(RedisClient *cl, RedisArena *arena, char *dst, int dstSize, int *pStatus) {
   static const char *fn = "redisxReadReplyAsync";
 
-  ClientPrivate *cp;
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  RedisArena *a = NULL;                   // The arena used for this RESP (if any)
   RESP *resp = NULL;
   char buf[REDIS_SIMPLE_STRING_SIZE+2];   // +<string>\0
   int size = 0;
   int status = X_SUCCESS;
 
-  if(rCheckClient(cl) != X_SUCCESS) return x_trace_null(fn, NULL);
-
-  cp = cl->priv;
-
-  if(cp == NULL) {
-    x_error(0, ENOTCONN, fn, "client is not initialized");
-    if(pStatus) *pStatus = X_NO_INIT;
-    return NULL;
-  }
-  if(!cp->isEnabled) {
-    x_error(0, ENOTCONN, fn, "client is not connected");
-    if(pStatus) *pStatus = X_NO_SERVICE;
-    return NULL;
-  }
-
   for(;;) {
-    size = rReadToken(cp, buf, REDIS_SIMPLE_STRING_SIZE + 1);
+    size = rReadTokenAsync(cp, buf, REDIS_SIMPLE_STRING_SIZE + 1);
     if(size < 0) {
       // Either read/recv had an error, or we got garbage...
       if(cp->isEnabled) x_trace_null(fn, NULL);
 
       // If persistent error disable this client so we don't attempt to read from it again...
-      if(size == X_NO_SERVICE) rCloseClientAsync(cl);
+      if(size == X_NO_SERVICE) cp->isEnabled = FALSE;
 
       if(pStatus) *pStatus = size;
       return NULL;
@@ -1006,7 +1976,10 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
 
     if(pStatus) *pStatus = X_SUCCESS;
 
-    resp = (RESP *) calloc(1, sizeof(RESP));
+    // Push messages and attributes are consumed separately, so keep them out of the arena...
+    a = (buf[0] == RESP3_PUSH || buf[0] == RESP3_ATTRIBUTE) ? NULL : arena;
+
+    resp = (RESP *) rCalloc(a, 1, sizeof(RESP));
     x_check_alloc(resp);
     resp->type = buf[0];
 
@@ -1016,10 +1989,14 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
       if(buf[1] == '?') {
         // Streaming RESP in parts...
         for(;;) {
-          RESP *r = redisxReadReplyAsync(cl, pStatus);
+          RESP *r = rReadReplyAsync(cl, a, NULL, 0, pStatus);
+          if(!r) {
+            rDestroyRESP(a, resp);
+            return x_trace_null(fn, NULL);
+          }
           if(r->type != RESP3_CONTINUED) {
             int type = r->type;
-            redisxDestroyRESP(r);
+            rDestroyRESP(a, r);
             fprintf(stderr, "WARNIG! Redis-X: expected type '%c', got type '%c'.", resp->type, type);
             return resp;
           }
@@ -1031,7 +2008,7 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
           }
 
           r->type = resp->type;
-          redisxAppendRESP(resp, r);
+          rAppendRESP(a, resp, r);
         }
       }
       else {
@@ -1075,7 +2052,7 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
     }
 
     case RESP3_DOUBLE: {
-      double *dval = (double *) calloc(1, sizeof(double));
+      double *dval = (double *) rCalloc(a, 1, sizeof(double));
       x_check_alloc(dval);
 
       *dval = xParseDouble(&buf[1], NULL);
@@ -1095,7 +2072,7 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
 
       if(resp->n <= 0) break;
 
-      component = (RESP **) malloc(resp->n * sizeof(RESP *));
+      component = (RESP **) rMalloc(a, resp->n * sizeof(RESP *));
       if(component == NULL) {
         status = x_error(X_FAILURE, errno, fn, "malloc() error (%d RESP)", resp->n);
         // We should get the data from the input even if we have nowhere to store...
@@ -1103,9 +2080,9 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
 
 
       for(i = 0; i < resp->n; i++) {
-        RESP *r = redisxReadReplyAsync(cl, pStatus);     // Always read RESP even if we don't have storage for it...
+        RESP *r = rReadReplyAsync(cl, a, NULL, 0, pStatus);     // Always read RESP even if we don't have storage for it...
         if(component) component[i] = r;
-        else redisxDestroyRESP(r);
+        else rDestroyRESP(a, r);
       }
 
       // Consistency check. Discard response if incomplete (because of read errors...)
@@ -1127,13 +2104,13 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
 
       if(resp->n <= 0) break;
 
-      dict = (RedisMap *) calloc(resp->n, sizeof(RedisMap));
+      dict = (RedisMap *) rCalloc(a, resp->n, sizeof(RedisMap));
       x_check_alloc(dict);
 
       for(i = 0; i < resp->n; i++) {
         RedisMap *e = &dict[i];
-        e->key = redisxReadReplyAsync(cl, pStatus);
-        e->value = redisxReadReplyAsync(cl, pStatus);
+        e->key = rReadReplyAsync(cl, a, NULL, 0, pStatus);
+        e->value = rReadReplyAsync(cl, a, NULL, 0, pStatus);
       }
       resp->value = dict;
 
@@ -1145,14 +2122,30 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
     case RESP3_VERBATIM_STRING:
       if(resp->n < 0) break;                          // no string token following!
 
-      resp->value = malloc(resp->n + 2);              // <string>\r\n
+      if(dst) {
+        // Read into the caller's buffer, and discard whatever does not fit...
+        int k = resp->n < dstSize ? resp->n : dstSize;
+
+        size = rReadBytesAsync(cp, dst, k);
+        if(size >= 0) size = rReadBytesAsync(cp, NULL, resp->n - k + 2);
+
+        if(size < 0) {
+          if(cp->isEnabled) x_trace_null(fn, NULL);
+          status = size;
+        }
+        else if(k < dstSize) dst[k] = '\0';
+
+        break;
+      }
+
+      resp->value = rMalloc(a, resp->n + 2);          // <string>\r\n
       if(resp->value == NULL) {
         status = x_error(X_FAILURE, errno, fn, "malloc() error (%d bytes)", (resp->n + 2));
         fprintf(stderr, "WARNING! Redis-X : not enough memory for bulk string reply (%d bytes). Skipping.\n", (resp->n + 2));
         // We still want to consume the bytes from the input...
       }
 
-      size = rReadBytes(cp, (char *) resp->value, resp->n + 2);
+      size = rReadBytesAsync(cp, (char *) resp->value, resp->n + 2);
 
       if(size < 0) {
         // Either read/recv had an error, or we got garbage...
@@ -1169,7 +2162,7 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
     case RESP_SIMPLE_STRING:
     case RESP_ERROR:
     case RESP3_BIG_NUMBER:
-      resp->value = malloc(size);
+      resp->value = rMalloc(a, size);
 
       if(resp->value == NULL) {
         status = x_error(X_FAILURE, errno, fn, "malloc() error (%d bytes)", size);
@@ -1193,7 +2186,8 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
       // FIXME workaround for Redis 4.x improper OK reply to QUIT
       if(!strcmp(buf, "OK")) {
         resp->type = RESP_SIMPLE_STRING;
-        resp->value = xStringCopyOf("OK");
+        resp->value = rMalloc(a, sizeof("OK"));
+        if(resp->value) strcpy((char *) resp->value, "OK");
       }
       else if(cp->isEnabled) {
         fprintf(stderr, "WARNING! Redis-X : invalid type '%c' in '%s'\n", buf[0], buf);
@@ -1203,20 +2197,373 @@ RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
 
   // Check for errors, and return NULL if there were any.
   if(status) {
-    redisxDestroyRESP(resp);
+    rDestroyRESP(a, resp);
     // If persistent error disable this client so we don't attempt to read from it again...
-    if(status == X_NO_SERVICE) rCloseClientAsync(cl);
+    if(status == X_NO_SERVICE) cp->isEnabled = FALSE;
     if(pStatus) *pStatus = status;
     return NULL;
   }
 
-  pthread_mutex_lock(&cp->pendingLock);
-  cp->pendingRequests--;
-  pthread_mutex_unlock(&cp->pendingLock);
+  return resp;
+}
+
+/**
+ * Reads a complete response from Redis, holding the read lock of the client for the duration.
+ *
+ * \param cl         Pointer to a Redis channel
+ * \param useArena   Whether to allocate the reply with all its components from a single arena.
+ * \param dst        (optional) Buffer into which to read a bulk string reply directly, or NULL.
+ * \param dstSize    (bytes) Size of the dst buffer.
+ * \param pStatus    Pointer to int in which to return an error status, or NULL if not required.
+ *
+ * \return      The RESP structure for the reponse received from Redis, or NULL if an error was encountered.
+ *
+ * @sa redisxReadReplyAsync()
+ * @sa redisxReadBulkStringAsync()
+ */
+static RESP *rReadReplyLockedAsync(RedisClient *cl, boolean useArena, char *dst, int dstSize, int *pStatus) {
+  static const char *fn = "redisxReadReplyAsync";
+
+  ClientPrivate *cp;
+  RedisArena arena = {};
+  RESP *resp;
+  int status = rCheckClient(cl);
+
+  if(status) {
+    if(pStatus) *pStatus = status;
+    return x_trace_null(fn, NULL);
+  }
 
+  cp = cl->priv;
+
+  if(!cp->isEnabled) {
+    x_error(0, ENOTCONN, fn, "client is not connected");
+    if(pStatus) *pStatus = X_NO_SERVICE;
+    return NULL;
+  }
+
+  // Hold the read lock for the entire reply, rather than for each token.
+  pthread_mutex_lock(&cp->readLock);
+
+  for(;;) {
+    RedisDiscard *discard = NULL;
+
+    resp = rReadReplyAsync(cl, useArena ? &arena : NULL, dst, dstSize, &status);
+    if(!resp) break;
+
+    pthread_mutex_lock(&cp->pendingLock);
+    cp->pendingRequests--;
+    cp->replySeq++;
+
+    // Replies that nobody asked for, e.g. to 'CLIENT REPLY ON', are dropped here.
+    if(cp->firstDiscard) {
+      if(cp->firstDiscard->ahead > 0) cp->firstDiscard->ahead--;
+      else {
+        discard = cp->firstDiscard;
+        cp->firstDiscard = discard->next;
+        if(!cp->firstDiscard) cp->lastDiscard = NULL;
+      }
+    }
+    pthread_mutex_unlock(&cp->pendingLock);
+
+    if(!discard) break;
+
+    free(discard);
+    if(useArena) rArenaFree(&arena);
+    else redisxDestroyRESP(resp);
+  }
+
+  pthread_mutex_unlock(&cp->readLock);
+
+  if(!resp) {
+    rArenaFree(&arena);
+    // If persistent error disable this client so we don't attempt to read from it again...
+    if(status == X_NO_SERVICE || !cp->isEnabled) rCloseClientAsync(cl);
+    if(pStatus) *pStatus = status;
+    return x_trace_null(fn, NULL);
+  }
+
+  if(pStatus) *pStatus = status;
   return resp;
 }
 
+/// \cond PRIVATE
+
+/**
+ * Locates a complete bulk string in the client's receive buffer, without consuming it.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param pos       Index in the receive buffer at which the bulk string should start. On success, it is
+ *                  advanced past the end of the bulk string.
+ * \param value     Pointer to the location in which to return the start of the bulk string in the buffer.
+ * \param length    Pointer to the location in which to return the bulk string length.
+ * \return          1 if a complete bulk string was found, 0 if more data is needed, or -1 if the data is not a
+ *                  (non-null) bulk string.
+ */
+static int rScanBulkStringAsync(const ClientPrivate *cp, int *pos, char **value, int *length) {
+  char *from = &cp->in[*pos];
+  const char *eol;
+  char *tail;
+  int start;
+  long n;
+
+  if(*pos >= cp->available) return 0;
+  if(*from != RESP_BULK_STRING) return -1;
+
+  eol = (const char *) memchr(from, '\n', cp->available - *pos);
+  if(!eol) return 0;
+
+  n = strtol(&from[1], &tail, 10);
+  if(tail != eol - 1 || *tail != '\r' || n < 0) return -1;
+
+  start = (int) (eol + 1 - cp->in);
+  if(start + n + 2 > cp->available) return 0;
+  if(cp->in[start + n] != '\r' || cp->in[start + n + 1] != '\n') return -1;
+
+  *value = &cp->in[start];
+  *length = (int) n;
+  *pos = start + (int) n + 2;
+
+  return 1;
+}
+
+/**
+ * Locates a complete PUB/SUB `message`, `pmessage`, or `smessage` frame at the head of the client's receive
+ * buffer. If found, the frame is consumed, and its components are terminated in place.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param part      Array of 4, in which to return the components of the message in the buffer.
+ * \param len       Array of 4, in which to return the component lengths.
+ * \return          The number of components (3 or 4) if a message frame was consumed, 0 if more data is needed,
+ *                  or -1 if the data in the buffer is not a message frame.
+ */
+static int rScanMessageAsync(ClientPrivate *cp, char **part, int *len) {
+  const char *in = &cp->in[cp->next];
+  int avail = cp->available - cp->next;
+  int pos = cp->next + 4, n, i;
+
+  if(avail <= 0) return 0;
+  if(*in != RESP_ARRAY) return -1;
+  if(avail < 4) return 0;
+  if((in[1] != '3' && in[1] != '4') || in[2] != '\r' || in[3] != '\n') return -1;
+
+  n = in[1] - '0';
+
+  for(i = 0; i < n; i++) {
+    int status = rScanBulkStringAsync(cp, &pos, &part[i], &len[i]);
+    if(status <= 0) return status;
+
+    if(i == 0) {
+      // Check that it is a message type we can deliver from the buffer.
+      if(n == 3) {
+        if(!(len[0] == 7 && memcmp(part[0], "message", 7) == 0) && !(len[0] == 8 && memcmp(part[0], "smessage", 8) == 0)) return -1;
+      }
+      else if(len[0] != 8 || memcmp(part[0], "pmessage", 8) != 0) return -1;
+    }
+  }
+
+  // Terminate the components in place, replacing the CR of their CR+LF.
+  for(i = 0; i < n; i++) part[i][len[i]] = '\0';
+
+  cp->next = pos;
+  return n;
+}
+
+/**
+ * Delivers the next PUB/SUB message received on a subscription client to subscribers directly from the client's
+ * receive buffer, without building a RESP for it. Message, channel, and pattern strings are passed to subscribers
+ * in place, and remain valid only until the subscribers return. If the message is only partially buffered, the
+ * unconsumed data is moved to the head of the buffer to receive the remainder. Messages that do not fit into the
+ * receive buffer and all other types of responses are left in the buffer for redisxReadReplyAsync().
+ *
+ * The subscribers are called without holding the client's read lock, so they may unsubscribe or disconnect.
+ * Meanwhile, the buffer is pinned: if the client needs to modify it, it continues with a new buffer instead, and
+ * the old one is freed here once the subscribers return.
+ *
+ * \param cl        Pointer to a subscription client.
+ * \return          The number of message components (&gt;0) if a message was delivered, 0 if the next response
+ *                  must be read via redisxReadReplyAsync() instead, or else an error code &lt;0.
+ *
+ * @sa rProcessSubscriptionMessage()
+ */
+int rReadMessageAsync(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  char *part[4], *buf = NULL;
+  int len[4];
+  int n = 0, status = X_SUCCESS;
+
+  if(!cp->isEnabled) return x_error(X_NO_SERVICE, ENOTCONN, "rReadMessageAsync", "client is not connected");
+
+  pthread_mutex_lock(&cp->readLock);
+
+  for(;;) {
+    int k;
+
+    n = rScanMessageAsync(cp, part, len);
+    if(n) break;
+
+    // Need more data...
+    if(cp->next >= cp->available) {
+      status = rReadChunkAsync(cp);
+      if(status) break;
+      continue;
+    }
+
+    rUnpinReceiveBufferAsync(cp);
+
+    // Move the partial message to the head of the buffer.
+    if(cp->next > 0) {
+      cp->available -= cp->next;
+      memmove(cp->in, &cp->in[cp->next], cp->available);
+      cp->next = 0;
+    }
+
+    // The message does not fit into the buffer...
+    if(cp->available >= cp->inSize) break;
+
+    k = rReceiveAsync(cp, &cp->in[cp->available], cp->inSize - cp->available);
+    if(k < 0) {
+      status = k;
+      break;
+    }
+    cp->available += k;
+  }
+
+  if(n > 0) {
+    pthread_mutex_lock(&cp->pendingLock);
+    cp->pendingRequests--;
+    cp->replySeq++;
+    pthread_mutex_unlock(&cp->pendingLock);
+
+    buf = cp->in;
+    cp->inPinned = TRUE;
+  }
+
+  pthread_mutex_unlock(&cp->readLock);
+
+  if(n > 0) {
+    rProcessSubscriptionMessage(cp->redis, part, len, n);
+
+    pthread_mutex_lock(&cp->readLock);
+    if(cp->in == buf) cp->inPinned = FALSE;
+    else free(buf);       // The client has moved on to a new buffer meanwhile.
+    pthread_mutex_unlock(&cp->readLock);
+  }
+
+  if(status) {
+    if(status == X_NO_SERVICE || !cp->isEnabled) rCloseClientAsync(cl);
+    return x_trace("rReadMessageAsync", NULL, status);
+  }
+
+  return n > 0 ? n : 0;
+}
+
+/// \endcond
+
+/**
+ * Reads a response from Redis and returns it. It should be used with an exclusive lock on a connected
+ * client, to collect responses for requests sent previously. It is up to the caller to keep track of
+ * what request the response is for. The responses arrive in the same order (and same nummber) as
+ * the requests that were sent out.
+ *
+ * To follow cluster MOVED or ASK redirections, the caller should check the reponse for redirections
+ * (e.g. via redisxIsRedirected()) and then act accordingly to re-submit the corresponding request,
+ * as is or with an ASKING directive to follow the redirection.
+ *
+ * \param cl         Pointer to a Redis channel
+ * \param pStatus    Pointer to int in which to return an error status, or NULL if not required.
+ *
+ * \return      The RESP structure for the reponse received from Redis, or NULL if an error was encountered
+ *              (errno will be set to describe the error, which may either be an errno produced by recv()
+ *              or EBADMSG if the message was corrupted and/or unparseable. If the error is irrecoverable
+ *              i.e., other than a timeout, the client will be disabled.)
+ *
+ * @sa redisxIgnoreReplyAsync()
+ * @sa redisxSetReplyTimeout()
+ * @sa redisxGetAvailableAsync()
+ * @sa redisxSendRequestAsync()
+ * @sa redisxSendArrayRequestAsync()
+ * @sa redisxGetLockedConnected()
+ * @sa redisxCheckRESP()
+ * @sa redisxIsRedirected()
+ */
+RESP *redisxReadReplyAsync(RedisClient *cl, int *pStatus) {
+  return rReadReplyLockedAsync(cl, FALSE, NULL, 0, pStatus);
+}
+
+/**
+ * Same as redisxReadReplyAsync(), except that the reply, with all of its components and values, is allocated from
+ * a few large blocks of memory (an arena) instead of individually, and it must be destroyed with
+ * redisxDestroyArenaRESP() in a single step. It is most useful for large aggregate replies (such as to
+ * `HGETALL`, `MGET`, or `SCAN`) which would otherwise involve allocating and freeing thousands of individual RESP
+ * structures and values.
+ *
+ * The returned RESP has the same layout as those returned by redisxReadReplyAsync(), and it can be read and
+ * inspected in the same way. However, you must not call redisxDestroyRESP() on it or on any of its components,
+ * and you must not free() or take ownership of any of its components or values. Use redisxCopyOfRESP() if you
+ * need an independent (heap allocated) copy of any part of it. Push messages and attributes, which may
+ * accompany the reply, are processed as usual.
+ *
+ * \param cl         Pointer to a Redis channel
+ * \param pStatus    Pointer to int in which to return an error status, or NULL if not required.
+ *
+ * \return      The RESP structure for the reponse received from Redis, or NULL if an error was encountered
+ *              (see redisxReadReplyAsync()).
+ *
+ * @sa redisxReadReplyAsync()
+ * @sa redisxDestroyArenaRESP()
+ * @sa redisxGetLockedConnected()
+ */
+RESP *redisxReadArenaReplyAsync(RedisClient *cl, int *pStatus) {
+  return rReadReplyLockedAsync(cl, TRUE, NULL, 0, pStatus);
+}
+
+/**
+ * Reads a bulk string response from Redis directly into the caller's buffer, without allocating a RESP for it. It
+ * should be used with an exclusive lock on a connected client, to collect a response to a request sent previously,
+ * which is expected to return a bulk string, such as `GET` or `HGET`. Large values are received directly into the
+ * supplied buffer, bypassing the client's receive buffer. As such, it is the most efficient way to retrieve large
+ * (binary) values from Redis, especially when the buffer can be reused for many reads.
+ *
+ * Values that do not fit into the buffer are truncated (the remainder is consumed and discarded), but the full
+ * length of the value is returned nevertheless, similar to snprintf(). The value in the buffer is terminated with
+ * '\0' only if there is space for it.
+ *
+ * \param cl         Pointer to a Redis channel
+ * \param buf        Buffer into which to read the value.
+ * \param size       (bytes) Size of the buffer.
+ *
+ * \return      The full length (&gt;=0) of the value, which may exceed the buffer size, or else REDIS_NULL if
+ *              the value does not exist, or REDIS_UNEXPECTED_RESP if the response was not a bulk string
+ *              (e.g. an error), or else another error code (&lt;0) from redisx.h / xchange.h.
+ *
+ * @sa redisxReadReplyAsync()
+ * @sa redisxGetValueInto()
+ * @sa redisxGetLockedConnected()
+ */
+int redisxReadBulkStringAsync(RedisClient *cl, char *buf, int size) {
+  static const char *fn = "redisxReadBulkStringAsync";
+
+  RESP *resp;
+  int status = X_SUCCESS;
+
+  if(!buf) return x_error(X_NULL, EINVAL, fn, "buffer is NULL");
+  if(size < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid buffer size: %d", size);
+
+  resp = rReadReplyLockedAsync(cl, FALSE, buf, size, &status);
+  prop_error(fn, status);
+
+  if(resp->type != RESP_BULK_STRING) {
+    if(resp->type == RESP_ERROR) status = x_error(REDIS_UNEXPECTED_RESP, EBADMSG, fn, "error response: %s", (char *) resp->value);
+    else status = x_error(REDIS_UNEXPECTED_RESP, EBADMSG, fn, "unexpected response type: '%c'", resp->type);
+  }
+  else if(resp->n < 0) status = REDIS_NULL;
+  else status = resp->n;
+
+  redisxDestroyRESP(resp);
+  return status;
+}
+
 /**
  * Sends a `RESET` request to the specified Redis client. The server will perform a reset as if the
  * client disconnected and reconnected again.
@@ -1233,6 +2580,7 @@ int redisxResetClient(RedisClient *cl) {
   prop_error(fn, redisxLockConnected(cl));
 
   status = redisxSendRequestAsync(cl, "RESET", NULL, NULL, NULL);
+  if(!status) status = rFlushOutAsync((ClientPrivate *) cl->priv);
   if(!status) {
     RESP *reply = redisxReadReplyAsync(cl, &status);
     if(!status) {
@@ -11,12 +11,17 @@
 #include <string.h>
 #include <errno.h>
 #include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <poll.h>
 
 #include "redisx-priv.h"
 
 /// \cond PRIVATE
 
-#define HASH_MASK   (16384 - 1);
+#define REDIS_HASH_SLOTS    16384                   ///< Number of hash slots in a Redis cluster
+#define HASH_MASK           (REDIS_HASH_SLOTS - 1)
+#define SCAN_RETRY_NANOS    1000000                 ///< [ns] Pause before trying to lock busy masters again for a scan.
 
 /**
  * A shard in a Redis cluster, serving a specific range of hashes.
@@ -29,6 +34,24 @@ typedef struct {
   int end;                      ///< Shard hash range end (inclusive)
 } RedisShard;
 
+/**
+ * Lookup table for the shard serving each hash slot. Lookups read it without locking, while
+ * reconfigurations publish a new table atomically, and release the old one only after all readers
+ * that might still be using it are done.
+ */
+typedef struct {
+  const RedisShard *shard[REDIS_HASH_SLOTS];  ///< The shard serving each hash slot, or NULL.
+} RedisSlotMap;
+
+/**
+ * A sharded PUB/SUB channel subscribed to on a cluster.
+ */
+typedef struct RedisShardChannel {
+  char *name;                       ///< The channel name
+  Redis *server;                    ///< The server on which the channel is subscribed, or NULL if not currently subscribed.
+  struct RedisShardChannel *next;   ///< The next channel in the list
+} RedisShardChannel;
+
 /**
  * Private cluster configuration data, not exposed to users
  *
@@ -39,6 +62,23 @@ typedef struct {
   RedisShard *shard;            ///< array containing information on each shard
   boolean usePipeline;          ///< Whether shards should have dedicated pipeline connections
   boolean reconfiguring;        ///< Whether the cluster is currently being reconfigured.
+  RedisSlotMap *slotMap;        ///< Slot-to-shard lookup table, swapped atomically on reconfiguration.
+  unsigned int epoch;           ///< Incremented each time a new slot map is published.
+  int readers[2];               ///< Number of lock-free slot map readers in even / odd epochs.
+  pthread_mutex_t refreshLock;  ///< mutex for the periodic refresher settings and signaling
+  pthread_cond_t refreshCond;   ///< condition to wake the periodic refresher
+  pthread_t refresherTID;       ///< Thread ID of the periodic refresher
+  boolean hasRefresher;         ///< Whether the cluster has a periodic refresher running
+  boolean stopRefresher;        ///< Whether the periodic refresher should stop
+  boolean refreshRequested;     ///< Whether a reload was requested from the periodic refresher
+  int refreshMillis;            ///< [ms] Interval between periodic reloads
+  enum redisx_read_pref readPref;   ///< Policy for selecting servers for read-only queries
+  unsigned int readNext;        ///< Counter for round-robin selection of servers for reads
+  pthread_mutex_t pubsubLock;   ///< mutex for the sharded PUB/SUB channels and subscribers
+  RedisShardChannel *channels;  ///< Sharded PUB/SUB channels subscribed to
+  MessageConsumer *subscribers; ///< Subscriber callbacks for sharded PUB/SUB messages
+  Redis **hosts;                ///< Servers on which the subscriber callbacks are registered
+  int n_hosts;                  ///< Number of servers on which the subscriber callbacks are registered
 } ClusterPrivate;
 
 /// \endcond
@@ -84,8 +124,37 @@ static const uint16_t crc_tab[] = { //
         0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0, //
 };
 
+/**
+ * Slicing tables for processing 8 bytes at a time: `crc_slice[k][b]` is the CRC-16 of byte `b` followed
+ * by `k` zero bytes. Slice 0 is the same as `crc_tab`.
+ */
+static uint16_t crc_slice[8][256];
+
+static void rInitCRCSlices() {
+  int i, k;
+
+  for(i = 0; i < 256; i++) crc_slice[0][i] = crc_tab[i];
+
+  for(k = 1; k < 8; k++) for(i = 0; i < 256; i++) {
+    uint16_t crc = crc_slice[k - 1][i];
+    crc_slice[k][i] = (crc << 8) ^ crc_tab[crc >> 8];
+  }
+}
+
 static uint16_t crc16(const uint8_t *buf, size_t len) {
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
   uint16_t crc = 0;
+
+  pthread_once(&once, rInitCRCSlices);
+
+  // 8 bytes at a time, with independent table lookups.
+  for(; len >= 8; len -= 8, buf += 8) {
+    crc = crc_slice[7][(crc >> 8) ^ buf[0]] ^ crc_slice[6][(crc & 0xFF) ^ buf[1]]
+        ^ crc_slice[5][buf[2]] ^ crc_slice[4][buf[3]] ^ crc_slice[3][buf[4]]
+        ^ crc_slice[2][buf[5]] ^ crc_slice[1][buf[6]] ^ crc_slice[0][buf[7]];
+  }
+
+  // The remaining bytes one at a time.
   while (len-- > 0) crc = (crc << 8) ^ crc_tab[((crc >> 8) ^ *(buf++)) & 0x00FF];
   return crc;
 }
@@ -117,13 +186,94 @@ uint16_t rCalcHash(const char *key) {
 /// \endcond
 
 /**
- * Discards the shards of a cluster configuration, freeing up the resources it used.
- * It should be called with the cluster mutex locked.
+ * Calculates the cluster hash slots for a set of Redis keys in a single call, e.g. to route a batch of
+ * keys to the appropriate cluster shards. The slots are calculated the same way as by Redis itself,
+ * using the ZMODEM / ACORN CRC-16 of the key, or of its hashtag if it has one.
+ *
+ * @param keys        The Redis keys. NULL and empty keys are allowed and map to slot 0.
+ * @param n           The number of keys.
+ * @param[out] slots  Array with at least `n` elements, in which to return the hash slot of each key.
+ * @return            X_SUCCESS (0) if successful, or else X_NULL if either array argument is NULL, or
+ *                    X_SIZE_INVALID if n is negative.
+ *
+ * @sa redisxClusterGetShard()
+ */
+int redisxClusterHashSlots(const char **keys, int n, uint16_t *slots) {
+  static const char *fn = "redisxClusterHashSlots";
+
+  int i;
+
+  if(n < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of keys: %d", n);
+  if(n == 0) return X_SUCCESS;
+  if(!keys) return x_error(X_NULL, EINVAL, fn, "input keys is NULL");
+  if(!slots) return x_error(X_NULL, EINVAL, fn, "output slots is NULL");
+
+  for(i = 0; i < n; i++) slots[i] = rCalcHash(keys[i]);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the server with the specified address from a set of shards.
+ *
+ * @param shards      array of cluster shards (it may be NULL).
+ * @param n_shards    the number of shards in the array.
+ * @param host        host name or IP address of the server
+ * @param port        port number of the server
+ * @return            the server with the specified address, or NULL if it is not in any of the shards.
+ */
+static Redis *rFindServer(const RedisShard *shards, int n_shards, const char *host, int port) {
+  int i;
+
+  if(!shards || !host) return NULL;
+
+  for(i = 0; i < n_shards; i++) {
+    const RedisShard *s = &shards[i];
+    int m;
+
+    for(m = 0; m < s->n_servers; m++) {
+      Redis *r = s->redis[m];
+      const RedisPrivate *np = (RedisPrivate *) r->priv;
+      if(np->port == port && np->hostname && strcmp(np->hostname, host) == 0) return r;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Checks if a set of shards contains the specified server instance.
+ *
+ * @param shards      array of cluster shards (it may be NULL).
+ * @param n_shards    the number of shards in the array.
+ * @param redis       the server instance.
+ * @return            TRUE (1) if the server is part of any of the shards, or else FALSE (0).
+ */
+static boolean rHasServer(const RedisShard *shards, int n_shards, const Redis *redis) {
+  int i;
+
+  if(!shards) return FALSE;
+
+  for(i = 0; i < n_shards; i++) {
+    const RedisShard *s = &shards[i];
+    int m;
+    for(m = 0; m < s->n_servers; m++) if(s->redis[m] == redis) return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+ * Discards the shards of a cluster configuration, freeing up the resources it used, except
+ * for the servers that are also used by another set of shards (e.g. by an updated
+ * configuration). It should be called with the cluster mutex locked.
  *
  * @param shards      array of cluster shards
  * @param n_shards    the number of shards in the array.
+ * @param keep        array of shards whose servers should be kept (it may be NULL).
+ * @param n_keep      the number of shards to keep.
  */
-static void rDiscardShards(RedisShard *shards, int n_shards) {
+static void rDiscardShards(RedisShard *shards, int n_shards, const RedisShard *keep, int n_keep) {
   int i;
 
   if(!shards) return;
@@ -134,6 +284,7 @@ static void rDiscardShards(RedisShard *shards, int n_shards) {
 
     for(m = 0; m < s->n_servers; m++) {
       Redis *r = s->redis[m];
+      if(!r || rHasServer(keep, n_keep, r)) continue;
       redisxDisconnect(r);
       redisxDestroy(r);
     }
@@ -144,18 +295,79 @@ static void rDiscardShards(RedisShard *shards, int n_shards) {
   free(shards);
 }
 
+/**
+ * Sends `READONLY` on a connected client of a replica, so it may serve read queries for its shard. The reply
+ * is skipped, so it does not reach the reader of the client (such as the pipeline consumer).
+ *
+ * @param cl        A client of a replica server
+ */
+static void rSendReadOnly(RedisClient *cl) {
+  if(redisxLockConnected(cl) != X_SUCCESS) return;
+  if(redisxSkipReplyAsync(cl) == X_SUCCESS) redisxSendRequestAsync(cl, "READONLY", NULL, NULL, NULL);
+  redisxUnlockClient(cl);
+}
+
+/**
+ * Enables reads on the existing connections of a server that has just become a replica. (Connections made
+ * to replicas enable reads as part of connecting.)
+ *
+ * @param redis     A cluster server that was demoted to replica.
+ */
+static void rEnableReplicaReads(Redis *redis) {
+  const RedisPrivate *np = (RedisPrivate *) redis->priv;
+  int i;
+
+  rSendReadOnly(redis->interactive);
+  for(i = 0; i < np->poolSize; i++) rSendReadOnly(&np->pool[i]);
+  rSendReadOnly(redis->pipeline);
+}
+
+/**
+ * Connect hook for cluster servers. It measures the round-trip time to the server, which is used for
+ * selecting the nearest server for reads.
+ *
+ * @param redis     A cluster server that has just connected.
+ *
+ * @sa redisxClusterSetReadPreference()
+ */
+static void rClusterNodeConnected(Redis *redis) {
+  RedisPrivate *np = (RedisPrivate *) redis->priv;
+  struct timespec start, end;
+  RESP *reply = NULL;
+  int status;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  status = redisxLockConnected(redis->interactive);
+  if(status != X_SUCCESS) return;
+
+  status = redisxSendRequestAsync(redis->interactive, "PING", NULL, NULL, NULL);
+  if(status == X_SUCCESS) reply = redisxReadReplyAsync(redis->interactive, &status);
+  redisxUnlockClient(redis->interactive);
+  redisxDestroyRESP(reply);
+
+  if(status != X_SUCCESS) return;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  np->latencyMicros = 1 + (int) (1000000LL * (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000);
+}
+
 /**
  * Returns the current cluster configuration obtained from the specified node. The caller must have
- * an exclusive lock on the configuration mutex of the initializing Redis instance.
+ * an exclusive lock on the configuration mutex of the initializing Redis instance. Servers that are
+ * already part of a prior configuration are reused as is (along with their connections), and only
+ * servers that are new to the cluster are created.
  *
  * @param redis             The node to use for discovery. It need not be in a connected state.
+ * @param prior             The prior shards, whose servers should be reused, or NULL.
+ * @param n_prior           The number of prior shards.
  * @param[out] n_shards     Pointer to integer in which to return the number of shards discovered
  *                          or else an error code &lt;0.
  * @return                  Array containing the discovered shards or NULL if there was an error.
  *
  * @sa rClusterSetShardsAsync()
  */
-static RedisShard *rClusterDiscoverAsync(Redis *redis, int *n_shards) {
+static RedisShard *rClusterDiscoverAsync(Redis *redis, const RedisShard *prior, int n_prior, int *n_shards) {
   static const char *fn = "rClusterDiscoverAsync";
 
   RESP *reply = NULL;
@@ -213,7 +425,7 @@ static RedisShard *rClusterDiscoverAsync(Redis *redis, int *n_shards) {
       if(!s->redis) {
         s->n_servers = 0;
         x_error(0, errno, fn, "alloc error (%d servers)\n", s->n_servers);
-        rDiscardShards(shards, *n_shards);
+        rDiscardShards(shards, *n_shards, prior, n_prior);
         *n_shards = X_FAILURE;
 
 
@@ -223,13 +435,33 @@ static RedisShard *rClusterDiscoverAsync(Redis *redis, int *n_shards) {
       }
 
       // Identify the servers for this shard.
-      for(m = 0; m < s->n_servers; s++) {
+      for(m = 0; m < s->n_servers; m++) {
         const RESP **node = (const RESP **) desc[2 + m]->value;
+
+        RedisPrivate *np;
+
+        // Reuse the server (and its connections) if we already know it.
+        s->redis[m] = rFindServer(prior, n_prior, (char *) node[0]->value, node[1]->n);
+        if(s->redis[m]) {
+          np = (RedisPrivate *) s->redis[m]->priv;
+          if(!np->isReplica && m > 0) {
+            // Demoted to replica: enable reads on its existing connections.
+            np->isReplica = TRUE;
+            if(redisxIsConnected(s->redis[m])) rEnableReplicaReads(s->redis[m]);
+          }
+          else np->isReplica = (m > 0);
+          continue;
+        }
+
         s->redis[m] = redisxInit((char *) node[0]->value);
 
         redisxSetPort(s->redis[m], node[1]->n);
         rCopyConfig(&p0->config, s->redis[m]);  // Inherit the configuration from the initial node...
         redisxSelectDB(s->redis[m], 0);         // ... Except, that only DB 0 is allowed for clusters.
+
+        np = (RedisPrivate *) s->redis[m]->priv;
+        np->isReplica = (m > 0);                // The first server is the master, the rest are replicas.
+        redisxAddConnectHook(s->redis[m], rClusterNodeConnected);
       }
     }
   }
@@ -243,6 +475,223 @@ static RedisShard *rClusterDiscoverAsync(Redis *redis, int *n_shards) {
   return shards;
 }
 
+/**
+ * Creates a slot-to-shard lookup table for the specified shards.
+ *
+ * @param shard       Array of shards
+ * @param n_shards    Number of shards in the array
+ * @return            The new lookup table, or NULL if there was an allocation error.
+ */
+static RedisSlotMap *rCreateSlotMap(const RedisShard *shard, int n_shards) {
+  RedisSlotMap *map;
+  int k;
+
+  map = (RedisSlotMap *) calloc(1, sizeof(RedisSlotMap));
+  if(!map) {
+    x_error(0, errno, "rCreateSlotMap", "alloc error (RedisSlotMap)");
+    return NULL;
+  }
+
+  for(k = 0; k < n_shards; k++) {
+    const RedisShard *s = &shard[k];
+    int i;
+
+    if(s->start < 0 || s->end >= REDIS_HASH_SLOTS) continue;
+    for(i = s->start; i <= s->end; i++) map->shard[i] = s;
+  }
+
+  return map;
+}
+
+/**
+ * Publishes a new slot-to-shard lookup table for a cluster, and waits until no lock-free reader may be
+ * using the prior one. The caller must have an exclusive lock on the cluster mutex.
+ *
+ * @param cp      Private cluster configuration
+ * @param map     The new slot lookup table (it may be NULL).
+ * @return        The prior slot lookup table, which is no longer used by any reader, and which the caller
+ *                should free, or NULL if there was none.
+ *
+ * @sa rAcquireSlotMap()
+ */
+static RedisSlotMap *rPublishSlotMapAsync(ClusterPrivate *cp, RedisSlotMap *map) {
+  RedisSlotMap *old = __atomic_exchange_n(&cp->slotMap, map, __ATOMIC_SEQ_CST);
+  unsigned int epoch = __atomic_fetch_add(&cp->epoch, 1, __ATOMIC_SEQ_CST);
+
+  // Readers that started in the prior epoch may still see the old map. New ones will use the other
+  // counter, so we do not have to wait for them.
+  while(__atomic_load_n(&cp->readers[epoch & 1], __ATOMIC_SEQ_CST) > 0) sched_yield();
+
+  return old;
+}
+
+/**
+ * Returns the current slot-to-shard lookup table of a cluster for a lock-free reader. The returned
+ * table (and the shards it references) remain valid until the reader calls rReleaseSlotMap().
+ *
+ * @param cp            Private cluster configuration
+ * @param[out] epoch    Pointer to the epoch the reader entered, to pass to rReleaseSlotMap().
+ * @return              The current slot lookup table, or NULL if there is none.
+ *
+ * @sa rReleaseSlotMap()
+ */
+static const RedisSlotMap *rAcquireSlotMap(ClusterPrivate *cp, unsigned int *epoch) {
+  for(;;) {
+    unsigned int e = __atomic_load_n(&cp->epoch, __ATOMIC_SEQ_CST);
+
+    __atomic_add_fetch(&cp->readers[e & 1], 1, __ATOMIC_SEQ_CST);
+
+    // If a new map was published meanwhile, the writer may not have seen us. Try again.
+    if(__atomic_load_n(&cp->epoch, __ATOMIC_SEQ_CST) == e) {
+      *epoch = e;
+      return __atomic_load_n(&cp->slotMap, __ATOMIC_SEQ_CST);
+    }
+
+    __atomic_sub_fetch(&cp->readers[e & 1], 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+/**
+ * Signals that a lock-free reader is done using the slot lookup table it obtained from rAcquireSlotMap().
+ *
+ * @param cp      Private cluster configuration
+ * @param epoch   The epoch returned by rAcquireSlotMap().
+ *
+ * @sa rAcquireSlotMap()
+ */
+static void rReleaseSlotMap(ClusterPrivate *cp, unsigned int epoch) {
+  __atomic_sub_fetch(&cp->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Checks if any of the sharded channels of a cluster is currently subscribed on the specified server. The
+ * caller should have an exclusive lock on the cluster's PUB/SUB mutex.
+ *
+ * @param cp          Private cluster data
+ * @param server      The server (shard master)
+ * @return            TRUE (1) if the server has sharded subscriptions, or else FALSE (0).
+ */
+static boolean rHasShardSubscriptions(const ClusterPrivate *cp, const Redis *server) {
+  const RedisShardChannel *c;
+
+  for(c = cp->channels; c; c = c->next) if(c->server == server) return TRUE;
+  return FALSE;
+}
+
+/**
+ * Registers the subscriber callbacks of a cluster on a server, unless they are registered there already.
+ * The caller should have an exclusive lock on the cluster's PUB/SUB mutex.
+ *
+ * @param cp          Private cluster data
+ * @param server      The server (shard master) that is to deliver sharded messages.
+ *
+ * @sa rPruneShardHosts()
+ */
+static void rAddShardHost(ClusterPrivate *cp, Redis *server) {
+  const MessageConsumer *c;
+  int i;
+
+  for(i = 0; i < cp->n_hosts; i++) if(cp->hosts[i] == server) return;
+
+  for(c = cp->subscribers; c; c = c->next) rAddSubscriber(server, c->channelStem, c->func, cp);
+
+  cp->hosts = (Redis **) realloc(cp->hosts, (cp->n_hosts + 1) * sizeof(Redis *));
+  x_check_alloc(cp->hosts);
+  cp->hosts[cp->n_hosts++] = server;
+}
+
+/**
+ * Removes the subscriber callbacks of a cluster from the servers that no longer have any of its sharded
+ * channels subscribed. Subscribers that were added to these servers otherwise (e.g. by the user) are not
+ * affected. The caller should have an exclusive lock on the cluster's PUB/SUB mutex.
+ *
+ * @param cp          Private cluster data
+ *
+ * @sa rAddShardHost()
+ */
+static void rPruneShardHosts(ClusterPrivate *cp) {
+  int i;
+
+  for(i = 0; i < cp->n_hosts; ) {
+    Redis *server = cp->hosts[i];
+    const MessageConsumer *c;
+
+    if(rHasShardSubscriptions(cp, server)) {
+      i++;
+      continue;
+    }
+
+    for(c = cp->subscribers; c; c = c->next) rRemoveSubscribers(server, c->func, cp);
+    cp->hosts[i] = cp->hosts[--cp->n_hosts];
+  }
+}
+
+/**
+ * Subscribes to a sharded channel on the specified server, making sure that the server also delivers
+ * messages to all subscriber callbacks of the cluster. The caller should have an exclusive lock on the
+ * cluster's PUB/SUB mutex.
+ *
+ * @param cp          Private cluster data
+ * @param server      The server (shard master) to subscribe on
+ * @param channel     The sharded channel
+ * @return            X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+static int rShardSubscribeAsync(ClusterPrivate *cp, Redis *server, const char *channel) {
+  rAddShardHost(cp, server);
+
+  prop_error("rShardSubscribeAsync", rSendSubscriptionCommand(server, "SSUBSCRIBE", channel));
+  return X_SUCCESS;
+}
+
+/**
+ * Unsubscribes from a sharded channel on the specified server, if its subscription client is connected.
+ *
+ * @param server      The server on which the channel was subscribed.
+ * @param channel     The sharded channel
+ */
+static void rShardUnsubscribe(Redis *server, const char *channel) {
+  if(redisxLockConnected(server->subscription) != X_SUCCESS) return;
+  redisxSendRequestAsync(server->subscription, "SUNSUBSCRIBE", channel, NULL, NULL);
+  redisxUnlockClient(server->subscription);
+}
+
+/**
+ * Moves the sharded PUB/SUB subscriptions to the masters serving their hash slots in the current
+ * configuration. Channels that remain with the same master are not affected. The caller should have
+ * an exclusive lock on the cluster mutex.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param shard       The current array of shards
+ * @param n_shards    Number of shards in the array
+ */
+static void rClusterResubscribeAsync(RedisCluster *cluster, const RedisShard *shard, int n_shards) {
+  ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
+  RedisShardChannel *c;
+
+  pthread_mutex_lock(&cp->pubsubLock);
+
+  for(c = cp->channels; c; c = c->next) {
+    const RedisShard *s = cp->slotMap ? cp->slotMap->shard[rCalcHash(c->name) & HASH_MASK] : NULL;
+    Redis *master = s ? s->redis[0] : NULL;
+    Redis *old = c->server;
+
+    if(master == old) continue;
+
+    xvprintf("Redis-X> Moving sharded subscription for %s.\n", c->name);
+
+    // Unbind first, so the confirmation from the old server is not mistaken for a migration.
+    c->server = NULL;
+    if(old && rHasServer(shard, n_shards, old)) rShardUnsubscribe(old, c->name);
+
+    if(master && rShardSubscribeAsync(cp, master, c->name) == X_SUCCESS) c->server = master;
+  }
+
+  // Before the servers that were dropped are destroyed.
+  rPruneShardHosts(cp);
+
+  pthread_mutex_unlock(&cp->pubsubLock);
+}
+
 /**
  * Sets a new set of shards for a cluster. All servers in the shards will have the cluster registered
  * as a parent, so they may all initiate reconfiguration if the hashes have `MOVED`. Normally this
@@ -259,9 +708,6 @@ static void rClusterSetShardsAsync(RedisCluster *cluster, RedisShard *shard, int
   ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
   int k;
 
-  // Destroy any different prior shards.
-  if(cp->shard && cp->shard != shard) rDiscardShards(cp->shard, cp->n_shards);
-
   // Register the cluster as the parent to all shard servers
   for(k = 0; k < n_shards; k++) {
     RedisShard *s = &shard[k];
@@ -273,6 +719,16 @@ static void rClusterSetShardsAsync(RedisCluster *cluster, RedisShard *shard, int
     }
   }
 
+  // Publish the slot lookup for the new shards, and release the old one.
+  free(rPublishSlotMapAsync(cp, rCreateSlotMap(shard, n_shards)));
+
+  // Move sharded subscriptions to their new shards, while the old servers are still around.
+  rClusterResubscribeAsync(cluster, shard, n_shards);
+
+  // Destroy any different prior shards, which are no longer referenced by lookups, except for the
+  // servers that were carried over to the new shards.
+  if(cp->shard && cp->shard != shard) rDiscardShards(cp->shard, cp->n_shards, shard, n_shards);
+
   // Assign the new shards to the cluster.
   cp->shard = shard;
   cp->n_shards = n_shards;
@@ -281,13 +737,13 @@ static void rClusterSetShardsAsync(RedisCluster *cluster, RedisShard *shard, int
 /// \cond PRIVATE
 
 /**
- * Thread to reload a changed cluster configuration. It should be called with the cluster mutex
- * already locked. The mutex will be released once the reconfiguration is complete.
+ * Reloads the cluster configuration from the first of its current servers that responds. The caller
+ * should have an exclusive lock on the cluster mutex.
  *
- * @param pCluster
+ * @param cluster   Pointer to a Redis cluster configuration
+ * @return          X_SUCCESS (0) if the configuration was reloaded, or else an error code &lt;0.
  */
-static void *ClusterRefreshThread(void *pCluster) {
-  RedisCluster *cluster = (RedisCluster *) pCluster;
+static int rClusterReloadAsync(RedisCluster *cluster) {
   ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
   int i;
 
@@ -297,15 +753,30 @@ static void *ClusterRefreshThread(void *pCluster) {
 
     for(m = 0; m < s->n_servers; m++) {
       int n_shards = 0;
-      RedisShard *shard = rClusterDiscoverAsync(s->redis[m], &n_shards);
+      RedisShard *shard = rClusterDiscoverAsync(s->redis[m], cp->shard, cp->n_shards, &n_shards);
 
-      if(n_shards >= 0) {
+      if(n_shards > 0) {
         rClusterSetShardsAsync(cluster, shard, n_shards);
-        break;
+        return X_SUCCESS;
       }
     }
   }
 
+  return x_error(X_NO_SERVICE, EAGAIN, "rClusterReloadAsync", "no cluster node responded");
+}
+
+/**
+ * Thread to reload a changed cluster configuration. It should be called with the cluster mutex
+ * already locked. The mutex will be released once the reconfiguration is complete.
+ *
+ * @param pCluster
+ */
+static void *ClusterRefreshThread(void *pCluster) {
+  RedisCluster *cluster = (RedisCluster *) pCluster;
+  ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
+
+  rClusterReloadAsync(cluster);
+
   cp->reconfiguring = FALSE;
   pthread_mutex_unlock(&cp->mutex);
 
@@ -313,10 +784,62 @@ static void *ClusterRefreshThread(void *pCluster) {
 }
 
 /**
- * Initiates the reloading of the cluster configuration in a separate background thread.
+ * Thread that reloads the cluster configuration periodically, and also on demand, whenever
+ * rClusterRefresh() is called.
+ *
+ * @param pCluster
+ */
+static void *ClusterRefresherThread(void *pCluster) {
+  RedisCluster *cluster = (RedisCluster *) pCluster;
+  ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
+
+  pthread_mutex_lock(&cp->refreshLock);
+
+  while(!cp->stopRefresher) {
+    struct timespec end;
+    long long ns;
+
+    if(!cp->refreshRequested) {
+      clock_gettime(CLOCK_REALTIME, &end);
+      ns = end.tv_nsec + 1000000LL * cp->refreshMillis;
+      end.tv_sec += ns / 1000000000LL;
+      end.tv_nsec = ns % 1000000000LL;
+
+      // Woken without a request (e.g. to apply a new interval): start a new wait.
+      if(pthread_cond_timedwait(&cp->refreshCond, &cp->refreshLock, &end) == 0 && !cp->refreshRequested) continue;
+      if(cp->stopRefresher) break;   // A pending request, if any, is dealt with below.
+    }
+
+    cp->refreshRequested = FALSE;
+    pthread_mutex_unlock(&cp->refreshLock);
+
+    pthread_mutex_lock(&cp->mutex);
+    rClusterReloadAsync(cluster);
+    cp->reconfiguring = FALSE;
+    pthread_mutex_unlock(&cp->mutex);
+
+    pthread_mutex_lock(&cp->refreshLock);
+  }
+
+  // Stopped with a refresh still requested: it will not happen now, so don't let it block the next
+  // one (e.g. after the next MOVED redirection).
+  if(cp->refreshRequested) {
+    cp->refreshRequested = FALSE;
+    cp->reconfiguring = FALSE;
+  }
+
+  pthread_mutex_unlock(&cp->refreshLock);
+
+  return NULL;
+}
+
+/**
+ * Initiates the reloading of the cluster configuration in the background. If the cluster has a
+ * periodic refresher, it is woken to reload the configuration now. Otherwise, the configuration
+ * is reloaded in a new background thread.
  *
  * @param cluster   Pointer to a Redis cluster configuration
- * @return          X_SUCCESS (0) if the reconfiguration thread was successfully launched
+ * @return          X_SUCCESS (0) if the reconfiguration was successfully initiated
  *                  or else an error code &lt;0 (with errno also indicating the type of
  *                  error).
  */
@@ -351,33 +874,207 @@ int rClusterRefresh(RedisCluster *cluster) {
   // Release the reconfigure mutex
   pthread_mutex_unlock(&mutex);
 
+  // Wake the periodic refresher, if there is one.
+  pthread_mutex_lock(&cp->refreshLock);
+  if(cp->hasRefresher) {
+    cp->refreshRequested = TRUE;
+    pthread_cond_signal(&cp->refreshCond);
+    pthread_mutex_unlock(&cp->refreshLock);
+    return X_SUCCESS;
+  }
+  pthread_mutex_unlock(&cp->refreshLock);
+
   // Get exclusive access to the cluster configuration
   pthread_mutex_lock(&cp->mutex);
 
   errno = 0;
   if(pthread_create(&tid, NULL, ClusterRefreshThread, (void *) cluster) != 0) {
+    cp->reconfiguring = FALSE;
     pthread_mutex_unlock(&cp->mutex);
     return x_error(X_FAILURE, errno, fn, "failed to start refresher thread");
   }
 
+  pthread_detach(tid);
+
   return X_SUCCESS;
 }
 
 /// \endcond
 
 /**
- * Returns the Redis server in a cluster which is to be used for queries relating to the
- * specified Redis keyword. In Redis cluster configurations, the database is distributed in
- * a way that each cluster node serves only a subset of the Redis keys. Thus, this function
- * allows to identify the node that serves a given key. The function supports Redish hashtags
- * according to the specification.
+ * Sets up periodic reloading of the cluster configuration in the background, or stops it. Each reload
+ * queries the current layout from one of the cluster nodes, and updates only what changed: servers that
+ * remain in the cluster are kept along with their connections, and only servers that joined or left the
+ * cluster are created or destroyed. The refresher is also woken up immediately when a `MOVED` redirection
+ * is detected. Without a periodic refresher, the configuration is reloaded only after `MOVED`
+ * redirections.
  *
- * @param cluster     Pointer to a Redis cluster configuration
- * @param key         The Redis keyword of interest. It may use hashtags (i.e., if the keyword
- *                    contains a segment enclosed in {} brackets, then the hash will be
- *                    calculated on the bracketed segment only. E.g. `{user:1000}.name` and
- *                    `{user:1000}.address` will both return the same hash for `user:1000` only.
- *                    NULL and empty keys are allowed and will return the shard for slot 0.
+ * @param cluster   Pointer to a Redis cluster configuration
+ * @param millis    [ms] Interval between reloads, or &lt;=0 to stop periodic reloading.
+ * @return          X_SUCCESS (0) if successful, or else an error code &lt;0 (errno will also
+ *                  indicate the type of error).
+ *
+ * @sa redisxClusterInit()
+ */
+int redisxClusterSetRefreshInterval(RedisCluster *cluster, int millis) {
+  static const char *fn = "redisxClusterSetRefreshInterval";
+
+  ClusterPrivate *cp;
+  pthread_t tid;
+  boolean stop;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  pthread_mutex_lock(&cp->refreshLock);
+
+  cp->refreshMillis = millis > 0 ? millis : 0;
+
+  if(millis > 0) {
+    if(!cp->hasRefresher) {
+      cp->stopRefresher = FALSE;
+      errno = 0;
+      if(pthread_create(&cp->refresherTID, NULL, ClusterRefresherThread, (void *) cluster) != 0) {
+        pthread_mutex_unlock(&cp->refreshLock);
+        return x_error(X_FAILURE, errno, fn, "failed to start refresher thread");
+      }
+      cp->hasRefresher = TRUE;
+    }
+    else pthread_cond_signal(&cp->refreshCond);  // Apply the new interval
+    pthread_mutex_unlock(&cp->refreshLock);
+    return X_SUCCESS;
+  }
+
+  stop = cp->hasRefresher;
+  tid = cp->refresherTID;
+  cp->hasRefresher = FALSE;
+  cp->stopRefresher = TRUE;
+  pthread_cond_signal(&cp->refreshCond);
+
+  pthread_mutex_unlock(&cp->refreshLock);
+
+  if(stop) pthread_join(tid, NULL);
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Returns the specified server if it is connected, or can be connected on demand.
+ *
+ * @param cp      Private cluster configuration
+ * @param r       A cluster server
+ * @return        The server, if connected, or else NULL.
+ */
+static Redis *rGetConnectedServer(const ClusterPrivate *cp, Redis *r) {
+  int status = X_SUCCESS;
+
+  // Already connected servers are returned without locking anything.
+  if(redisxIsConnected(r)) return r;
+
+  if(rConfigLock(r) != X_SUCCESS) return NULL;
+  if(!redisxIsConnected(r)) status = rConnectAsync(r, cp->usePipeline);
+  rConfigUnlock(r);
+
+  return status == X_SUCCESS ? r : NULL;
+}
+
+/**
+ * Selects a server of a shard for read-only queries according to the read preference of the cluster.
+ *
+ * @param cp      Private cluster configuration
+ * @param s       The shard
+ * @return        A connected server of the shard, or NULL if none could be connected.
+ */
+static Redis *rSelectReadServer(ClusterPrivate *cp, const RedisShard *s) {
+  Redis *r = NULL;
+  int m, best = -1;
+
+  switch(cp->readPref) {
+    case REDISX_READ_PREFER_REPLICA:
+      for(m = 1; m < s->n_servers; m++) if(redisxIsConnected(s->redis[m])) return s->redis[m];
+      for(m = 1; m < s->n_servers; m++) if((r = rGetConnectedServer(cp, s->redis[m])) != NULL) return r;
+      break;
+
+    case REDISX_READ_NEAREST:
+      for(m = 0; m < s->n_servers; m++) {
+        const RedisPrivate *np = (RedisPrivate *) s->redis[m]->priv;
+        if(!rGetConnectedServer(cp, s->redis[m]) || np->latencyMicros <= 0) continue;
+        if(best < 0 || np->latencyMicros < ((RedisPrivate *) s->redis[best]->priv)->latencyMicros) best = m;
+      }
+      if(best >= 0) return s->redis[best];
+      break;
+
+    case REDISX_READ_ROUND_ROBIN:
+      if(s->n_servers > 0) {
+        int k = (int) (__atomic_fetch_add(&cp->readNext, 1, __ATOMIC_RELAXED) % s->n_servers);
+        for(m = 0; m < s->n_servers; m++) if((r = rGetConnectedServer(cp, s->redis[(k + m) % s->n_servers])) != NULL) return r;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  // Master, or else any server that can be connected.
+  for(m = 0; m < s->n_servers; m++) if((r = rGetConnectedServer(cp, s->redis[m])) != NULL) return r;
+
+  return NULL;
+}
+
+/**
+ * Returns a connected server from the shard that serves the specified hash slot. The shard is looked up
+ * from the cluster's slot map without locking, and only a server that needs to be connected on demand
+ * is locked for configuration.
+ *
+ * @param cluster     Pointer to an initialized Redis cluster configuration
+ * @param hash        The hash slot of interest
+ * @param read        Whether the server is for read-only queries, and so it may be selected according to the
+ *                    read preference of the cluster. Otherwise, the master is preferred.
+ * @return            A connected Redis server (cluster shard), which serves the given slot, or NULL
+ *                    if no node could be connected to serve queries for the slot (errno = EAGAIN).
+ */
+static Redis *rClusterGetShardForSlot(RedisCluster *cluster, uint16_t hash, boolean read) {
+  ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
+  const RedisSlotMap *map;
+  const RedisShard *s = NULL;
+  Redis *r = NULL;
+  unsigned int epoch;
+
+  map = rAcquireSlotMap(cp, &epoch);
+  if(map) s = map->shard[hash & HASH_MASK];
+
+  if(s) {
+    int m;
+
+    if(read) r = rSelectReadServer(cp, s);
+    else for(m = 0; !r && m < s->n_servers; m++) r = rGetConnectedServer(cp, s->redis[m]);
+  }
+
+  rReleaseSlotMap(cp, epoch);
+
+  if(!r) x_error(0, EAGAIN, "rClusterGetShardForSlot", "no server found for hash %hu", hash);
+  return r;
+}
+
+/// \endcond
+
+/**
+ * Returns the Redis server in a cluster which is to be used for queries relating to the
+ * specified Redis keyword. In Redis cluster configurations, the database is distributed in
+ * a way that each cluster node serves only a subset of the Redis keys. Thus, this function
+ * allows to identify the node that serves a given key. The function supports Redish hashtags
+ * according to the specification.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param key         The Redis keyword of interest. It may use hashtags (i.e., if the keyword
+ *                    contains a segment enclosed in {} brackets, then the hash will be
+ *                    calculated on the bracketed segment only. E.g. `{user:1000}.name` and
+ *                    `{user:1000}.address` will both return the same hash for `user:1000` only.
+ *                    NULL and empty keys are allowed and will return the shard for slot 0.
  * @return            A connected Redis server (cluster shard), which can be used for
  *                    queries on the given keyword, or NULL if either input pointer is NULL
  *                    (errno = EINVAL), or the cluster has not been initialized (errno = ENXIO),
@@ -390,49 +1087,90 @@ int rClusterRefresh(RedisCluster *cluster) {
 Redis *redisxClusterGetShard(RedisCluster *cluster, const char *key) {
   static const char *fn = "redisxClusterGetShard";
 
-  ClusterPrivate *cp;
-  uint16_t hash;
-  int i;
+  Redis *r;
 
   if(!cluster) {
     x_error(X_NULL, EINVAL, fn, "cluster is NULL");
     return NULL;
   }
 
-  cp = (ClusterPrivate *) cluster->priv;
-  if(!cp) {
+  if(!cluster->priv) {
     x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
     return NULL;
   }
 
-  hash = rCalcHash(key);
+  r = rClusterGetShardForSlot(cluster, rCalcHash(key), FALSE);
+  if(!r) return x_trace_null(fn, NULL);
 
-  pthread_mutex_lock(&cp->mutex);
+  return r;
+}
 
-  for(i = 0; i < cp->n_shards; i++) {
-    const RedisShard *s = &cp->shard[i];
-    if(hash >= s->start && hash <= s->end) {
-      int m;
+/**
+ * Sets the policy for selecting cluster nodes for read-only queries via redisxClusterGetReadShard(). By
+ * default, reads are served by the master of each shard. Other policies spread reads over the replicas
+ * also, which are automatically enabled to serve reads (via `READONLY`) when they connect. Note, that
+ * replicas may lag behind the master, so reads from replicas may return slightly stale data.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param pref        The read preference policy
+ * @return            X_SUCCESS (0) if successful, or else X_NULL if the cluster is NULL, X_NO_INIT
+ *                    if the cluster is not initialized, or X_FAILURE if the policy is invalid.
+ *
+ * @sa redisxClusterGetReadShard()
+ */
+int redisxClusterSetReadPreference(RedisCluster *cluster, enum redisx_read_pref pref) {
+  static const char *fn = "redisxClusterSetReadPreference";
 
-      for(m = 0; m < s->n_servers; m++) {
-        Redis *r = s->redis[m];
+  ClusterPrivate *cp;
 
-        if(rConfigLock(r) != X_SUCCESS) continue;
-        if(!redisxIsConnected(r)) if(rConnectAsync(r, cp->usePipeline) != X_SUCCESS) {
-          rConfigUnlock(r);
-          continue;
-        }
-        rConfigUnlock(r);
-        pthread_mutex_unlock(&cp->mutex);
-        return r;
-      }
-    }
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  if(pref < REDISX_READ_MASTER || pref > REDISX_READ_ROUND_ROBIN) return x_error(X_FAILURE, EINVAL, fn, "invalid read preference: %d", pref);
+
+  cp->readPref = pref;
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the Redis server in a cluster which is to be used for read-only queries relating to the
+ * specified Redis keyword, according to the read preference set for the cluster. For queries that
+ * modify the database, you should use redisxClusterGetShard() instead, which always prefers the
+ * master.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param key         The Redis keyword of interest. It may use hashtags. NULL and empty keys are
+ *                    allowed and will return a server for slot 0.
+ * @return            A connected Redis server (master or replica), which can be used for read-only
+ *                    queries on the given keyword, or NULL if either input pointer is NULL
+ *                    (errno = EINVAL), or the cluster has not been initialized (errno = ENXIO),
+ *                    or if no node could be connected to serve queries for the given key
+ *                    (errno = EAGAIN).
+ *
+ * @sa redisxClusterSetReadPreference()
+ * @sa redisxClusterGetShard()
+ */
+Redis *redisxClusterGetReadShard(RedisCluster *cluster, const char *key) {
+  static const char *fn = "redisxClusterGetReadShard";
+
+  Redis *r;
+
+  if(!cluster) {
+    x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+    return NULL;
   }
 
-  pthread_mutex_unlock(&cp->mutex);
+  if(!cluster->priv) {
+    x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+    return NULL;
+  }
 
-  x_error(0, EAGAIN, fn, "no server found for hash %hu", hash);
-  return NULL;
+  r = rClusterGetShardForSlot(cluster, rCalcHash(key), TRUE);
+  if(!r) return x_trace_null(fn, NULL);
+
+  return r;
 }
 
 /// \cond PRIVATE
@@ -544,7 +1282,7 @@ RedisCluster *redisxClusterInit(Redis *node) {
   RedisCluster *cluster;
   ClusterPrivate *cp;
 
-  if(!rConfigLock(node)) return x_trace_null(fn, NULL);
+  if(rConfigLock(node) != X_SUCCESS) return x_trace_null(fn, NULL);
 
   cluster = (RedisCluster *) calloc(1, sizeof(RedisCluster));
   x_check_alloc(cluster);
@@ -556,8 +1294,11 @@ RedisCluster *redisxClusterInit(Redis *node) {
   cp->usePipeline = redisxHasPipeline(node);
 
   pthread_mutex_init(&cp->mutex, NULL);
+  pthread_mutex_init(&cp->refreshLock, NULL);
+  pthread_cond_init(&cp->refreshCond, NULL);
+  pthread_mutex_init(&cp->pubsubLock, NULL);
 
-  cp->shard = rClusterDiscoverAsync(node, &cp->n_shards);
+  cp->shard = rClusterDiscoverAsync(node, NULL, 0, &cp->n_shards);
   rClusterSetShardsAsync(cluster, cp->shard, cp->n_shards);
 
   rConfigUnlock(node);
@@ -583,16 +1324,38 @@ void redisxClusterDestroy(RedisCluster *cluster) {
 
   if(!cluster) return;
 
+  redisxClusterSetRefreshInterval(cluster, 0);
   redisxClusterDisconnect(cluster);
 
   cp = (ClusterPrivate *) cluster->priv;
   if(cp) {
     pthread_mutex_lock(&cp->mutex);
 
-    rDiscardShards(cp->shard, cp->n_shards);
+    free(rPublishSlotMapAsync(cp, NULL));
+    rDiscardShards(cp->shard, cp->n_shards, NULL, 0);
 
     pthread_mutex_unlock(&cp->mutex);
     pthread_mutex_destroy(&cp->mutex);
+    pthread_mutex_destroy(&cp->refreshLock);
+    pthread_cond_destroy(&cp->refreshCond);
+
+    while(cp->channels) {
+      RedisShardChannel *next = cp->channels->next;
+      free(cp->channels->name);
+      free(cp->channels);
+      cp->channels = next;
+    }
+
+    while(cp->subscribers) {
+      MessageConsumer *next = cp->subscribers->next;
+      if(cp->subscribers->channelStem) free(cp->subscribers->channelStem);
+      free(cp->subscribers);
+      cp->subscribers = next;
+    }
+
+    if(cp->hosts) free(cp->hosts);
+
+    pthread_mutex_destroy(&cp->pubsubLock);
 
     free(cp);
   }
@@ -832,9 +1595,8 @@ RESP *redisxClusterAskMigrating(Redis *redis, const char **args, const int *leng
     return x_trace_null(fn, NULL);
   }
 
-  cl = redis->interactive;
-  s = redisxLockConnected(cl);
-  if(s) {
+  cl = rLockInteractive(redis, &s);
+  if(!cl) {
     if(status) *status = s;
     return x_trace_null(fn, NULL);
   }
@@ -914,3 +1676,1232 @@ int redisxClusterAskMigratingAsync(RedisClient *cl, const char **args, const int
 }
 
 
+
+/// \cond PRIVATE
+
+/**
+ * A key in a multi-key cluster request, along with the hash slot it belongs to.
+ */
+typedef struct {
+  uint16_t slot;                ///< The hash slot of the key
+  int idx;                      ///< The index of the key in the original request
+} RedisKeySlot;
+
+/**
+ * A group of keys in a multi-key cluster request that share the same hash slot, and which can
+ * therefore be sent to a shard as a single sub-command.
+ */
+typedef struct {
+  int from;                     ///< Index of the first key of the group in the slot-ordered key list
+  int n;                        ///< Number of keys in the group
+  Redis *redis;                 ///< The shard the group is sent to
+  RESP *reply;                  ///< The reply received for the group's sub-command
+  boolean sent;                 ///< Whether the group's sub-command was sent, and so a reply is due for it
+  int status;                   ///< The status of the group's sub-command
+} RedisSlotGroup;
+
+/**
+ * Function that processes the reply to the sub-command of a slot group of a multi-key cluster
+ * request.
+ *
+ * @param reply     The reply to the group's sub-command. The function may take ownership of
+ *                  (and clear) its components, but not the reply itself.
+ * @param keys      The slot-ordered keys in the group.
+ * @param n         The number of keys in the group.
+ * @param ctx       Data to collect the results in.
+ * @return          X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+typedef int (*RedisGatherFunction)(RESP *reply, const RedisKeySlot *keys, int n, void *ctx);
+
+/**
+ * A multi-key request to be scattered across the shards of a cluster.
+ */
+typedef struct {
+  const char *command;          ///< The Redis command, e.g. "MGET"
+  const char **args;            ///< Per-key arguments, the first of each being the key itself
+  const int *lengths;           ///< Byte lengths for the per-key arguments, or NULL to use strlen()
+  int stride;                   ///< Number of arguments per key, e.g. 2 for key / value pairs.
+  boolean readOnly;             ///< Whether the request is read-only, which may be served by replicas.
+  RedisKeySlot *keys;           ///< Keys ordered by hash slot
+} RedisMultiKeyRequest;
+
+/// \endcond
+
+static int rCompareKeySlots(const void *a, const void *b) {
+  const RedisKeySlot *A = (const RedisKeySlot *) a;
+  const RedisKeySlot *B = (const RedisKeySlot *) b;
+
+  if(A->slot != B->slot) return A->slot < B->slot ? -1 : 1;
+  return A->idx - B->idx;   // preserve the original key order within a slot
+}
+
+/**
+ * Sends the sub-command for a group of keys that share a hash slot.
+ *
+ * @param cl      Locked client of the shard serving the group.
+ * @param req     The multi-key request
+ * @param g       The slot group
+ * @param ask     Whether to send the sub-command with the `ASKING` directive.
+ * @return        X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+static int rSendSlotGroupAsync(RedisClient *cl, const RedisMultiKeyRequest *req, const RedisSlotGroup *g, boolean ask) {
+  static const char *fn = "rSendSlotGroupAsync";
+
+  const char **args;
+  int *lengths;
+  int i, k = 1, n = 1 + g->n * req->stride, status;
+
+  args = (const char **) malloc(n * sizeof(char *));
+  if(!args) return x_error(X_FAILURE, errno, fn, "alloc error (%d char *)", n);
+
+  lengths = (int *) malloc(n * sizeof(int));
+  if(!lengths) {
+    free(args);
+    return x_error(X_FAILURE, errno, fn, "alloc error (%d int)", n);
+  }
+
+  args[0] = req->command;
+  lengths[0] = 0;
+
+  for(i = 0; i < g->n; i++) {
+    int j = req->keys[g->from + i].idx * req->stride, m;
+    for(m = 0; m < req->stride; m++, k++) {
+      args[k] = req->args[j + m];
+      lengths[k] = req->lengths ? req->lengths[j + m] : 0;
+    }
+  }
+
+  if(ask) status = redisxClusterAskMigratingAsync(cl, args, lengths, n);
+  else status = redisxSendArrayRequestAsync(cl, args, lengths, n);
+
+  free(lengths);
+  free(args);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+/**
+ * Pipelines the sub-commands of all slot groups that are assigned to the given shard, and then
+ * collects the replies for each.
+ *
+ * @param redis     The shard
+ * @param req       The multi-key request
+ * @param groups    All slot groups of the request. Only those assigned to the given shard are
+ *                  processed.
+ * @param n_groups  The number of slot groups
+ * @param ask       Whether to send the sub-commands with the `ASKING` directive.
+ */
+static void rRequestSlotGroups(Redis *redis, const RedisMultiKeyRequest *req, RedisSlotGroup *groups, int n_groups, boolean ask) {
+  RedisClient *cl;
+  int i, status = X_SUCCESS;
+
+  cl = rLockInteractive(redis, &status);
+
+  if(cl) {
+    redisxClearAttributesAsync(cl);
+
+    for(i = 0; i < n_groups; i++) {
+      RedisSlotGroup *g = &groups[i];
+      if(g->redis != redis) continue;
+      if(status == X_SUCCESS) status = rSendSlotGroupAsync(cl, req, g, ask);
+      g->sent = (status == X_SUCCESS);
+      g->status = status;
+    }
+
+    // Read the replies for all groups that were sent, in order, even if sending the rest failed, so
+    // none are left behind for the next user of the client.
+    for(i = 0; i < n_groups; i++) {
+      RedisSlotGroup *g = &groups[i];
+      if(g->redis != redis || !g->sent) continue;
+      g->reply = redisxReadReplyAsync(cl, &g->status);
+    }
+
+    redisxUnlockClient(cl);
+  }
+  else for(i = 0; i < n_groups; i++) if(groups[i].redis == redis) groups[i].status = status;
+}
+
+/**
+ * Scatters a multi-key request to the shards of a cluster, and gathers the results. Keys are grouped
+ * by hash slot, and a sub-command is sent for each group, with all sub-commands to the same shard
+ * pipelined on the shard's interactive connection, and the shards themselves queried in parallel
+ * (with OpenMP). Groups that receive a `MOVED` or `ASK` redirection are re-sent once to the
+ * redirected node.
+ *
+ * @param cluster   Pointer to a Redis cluster configuration
+ * @param req       The multi-key request (without the slot-ordered keys, which are filled here).
+ * @param n         The number of keys in the request.
+ * @param gather    The function that processes the reply for each slot group.
+ * @param ctx       Data to collect the results in.
+ * @return          X_SUCCESS (0) if successful, X_INCOMPLETE if the request failed for some,
+ *                  but not all, of the keys, or else an error code &lt;0 if it failed for all.
+ */
+static int rClusterScatterGather(RedisCluster *cluster, RedisMultiKeyRequest *req, int n, RedisGatherFunction gather, void *ctx) {
+  static const char *fn = "rClusterScatterGather";
+
+  RedisSlotGroup *groups;
+  Redis **shards;
+  int i, n_groups = 0, n_shards = 0, n_failed = 0, status = X_SUCCESS;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+  if(!cluster->priv) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+  if(!req->args) return x_error(X_NULL, EINVAL, fn, "input keys is NULL");
+  if(n < 1) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of keys: %d", n);
+
+  req->keys = (RedisKeySlot *) malloc(n * sizeof(RedisKeySlot));
+  if(!req->keys) return x_error(X_FAILURE, errno, fn, "alloc error (%d RedisKeySlot)", n);
+
+  for(i = 0; i < n; i++) {
+    req->keys[i].slot = rCalcHash(req->args[i * req->stride]);
+    req->keys[i].idx = i;
+  }
+
+  qsort(req->keys, n, sizeof(RedisKeySlot), rCompareKeySlots);
+
+  groups = (RedisSlotGroup *) calloc(n, sizeof(RedisSlotGroup));
+  shards = (Redis **) calloc(n, sizeof(Redis *));
+  if(!groups || !shards) {
+    if(groups) free(groups);
+    if(shards) free(shards);
+    free(req->keys);
+    return x_error(X_FAILURE, errno, fn, "alloc error (%d groups)", n);
+  }
+
+  // Group the keys by slot, and assign each group to a shard.
+  for(i = 0; i < n; i++) {
+    RedisSlotGroup *g;
+    int k;
+
+    if(i > 0 && req->keys[i].slot == req->keys[i - 1].slot) {
+      groups[n_groups - 1].n++;
+      continue;
+    }
+
+    g = &groups[n_groups++];
+    g->from = i;
+    g->n = 1;
+    g->redis = rClusterGetShardForSlot(cluster, req->keys[i].slot, req->readOnly);
+
+    if(!g->redis) {
+      g->status = X_NO_SERVICE;
+      continue;
+    }
+
+    for(k = 0; k < n_shards; k++) if(shards[k] == g->redis) break;
+    if(k == n_shards) shards[n_shards++] = g->redis;
+  }
+
+  // Query the shards in parallel.
+#ifdef _OPENMP
+#  pragma omp parallel for
+#endif
+  for(i = 0; i < n_shards; i++) rRequestSlotGroups(shards[i], req, groups, n_groups, FALSE);
+
+  // Retry redirected groups once on the node they were redirected to.
+  for(i = 0; i < n_groups; i++) {
+    RedisSlotGroup *g = &groups[i];
+
+    if(redisxClusterIsRedirected(g->reply)) {
+      boolean ask = redisxClusterIsMigrating(g->reply);
+
+      g->redis = redisxClusterGetRedirection(cluster, g->reply, TRUE);
+      redisxDestroyRESP(g->reply);
+      g->reply = NULL;
+
+      if(g->redis) rRequestSlotGroups(g->redis, req, g, 1, ask);
+      else g->status = X_NO_SERVICE;
+    }
+  }
+
+  // Gather the results in the original key order.
+  for(i = 0; i < n_groups; i++) {
+    RedisSlotGroup *g = &groups[i];
+
+    if(g->status == X_SUCCESS) g->status = gather(g->reply, &req->keys[g->from], g->n, ctx);
+    if(g->status != X_SUCCESS) {
+      n_failed += g->n;
+      if(!status) status = g->status;
+    }
+
+    redisxDestroyRESP(g->reply);
+  }
+
+  free(shards);
+  free(groups);
+  free(req->keys);
+  req->keys = NULL;
+
+  if(n_failed == 0) return X_SUCCESS;
+  if(n_failed < n) return x_error(X_INCOMPLETE, EAGAIN, fn, "request failed for %d of %d keys", n_failed, n);
+
+  prop_error(fn, status);
+  return status;
+}
+
+static int rGatherValues(RESP *reply, const RedisKeySlot *keys, int n, void *ctx) {
+  RESP **values = (RESP **) ctx;
+  RESP **component;
+  int i;
+
+  prop_error("rGatherValues", redisxCheckRESP(reply, RESP_ARRAY, n));
+
+  component = (RESP **) reply->value;
+  for(i = 0; i < n; i++) {
+    values[keys[i].idx] = component[i];
+    component[i] = NULL;
+  }
+
+  return X_SUCCESS;
+}
+
+static int rGatherOK(RESP *reply, const RedisKeySlot *keys, int n, void *ctx) {
+  static const char *fn = "rGatherOK";
+
+  (void) keys;
+  (void) n;
+  (void) ctx;
+
+  prop_error(fn, redisxCheckRESP(reply, RESP_SIMPLE_STRING, 0));
+  if(strcmp("OK", (char *) reply->value) != 0) return x_error(REDIS_UNEXPECTED_RESP, ENOMSG, fn, "unexpected response: %s", (char *) reply->value);
+
+  return X_SUCCESS;
+}
+
+static int rGatherCount(RESP *reply, const RedisKeySlot *keys, int n, void *ctx) {
+  (void) keys;
+  (void) n;
+
+  prop_error("rGatherCount", redisxCheckRESP(reply, RESP_INT, 0));
+  *(int *) ctx += reply->n;
+
+  return X_SUCCESS;
+}
+
+/**
+ * Retrieves the values of multiple keys from a Redis cluster, like `MGET`, but for keys that may be
+ * distributed across different hash slots and shards. The keys are grouped by hash slot, and one
+ * `MGET` sub-command is sent for each group, with the sub-commands pipelined to each shard and the
+ * shards queried in parallel. The replies are reassembled in the original key order. Groups that
+ * were redirected (`MOVED` or `ASK`) are retried once on the node they were redirected to. The
+ * servers are selected according to the read preference of the cluster.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param keys        The Redis keys to retrieve.
+ * @param n           The number of keys.
+ * @param[out] status (optional) pointer in which to return X_SUCCESS (0) if successful, or X_INCOMPLETE
+ *                    if the values could not be obtained for some of the keys, or else another error
+ *                    code &lt;0.
+ * @return            A RESP array with the values for each of the keys in the same order as the keys
+ *                    (with RESP_BULK_STRING components, which may be (nil) for keys that do not exist,
+ *                    or NULL components for keys whose values could not be obtained), or NULL if
+ *                    the values could not be obtained for any of the keys.
+ *
+ * @sa redisxClusterMSet()
+ * @sa redisxClusterDelete()
+ * @sa redisxClusterGetShard()
+ */
+RESP *redisxClusterMGet(RedisCluster *cluster, const char **keys, int n, int *status) {
+  static const char *fn = "redisxClusterMGet";
+
+  RedisMultiKeyRequest req = { "MGET", keys, NULL, 1, TRUE, NULL };
+  RESP *array;
+  int s;
+
+  array = (RESP *) calloc(1, sizeof(RESP));
+  x_check_alloc(array);
+
+  array->type = RESP_ARRAY;
+  array->n = n > 0 ? n : 0;
+
+  if(n > 0) {
+    array->value = calloc(n, sizeof(RESP *));
+    x_check_alloc(array->value);
+  }
+
+  s = rClusterScatterGather(cluster, &req, n, rGatherValues, array->value);
+  if(status) *status = s;
+
+  if(s != X_SUCCESS && s != X_INCOMPLETE) {
+    redisxDestroyRESP(array);
+    return x_trace_null(fn, NULL);
+  }
+
+  return array;
+}
+
+/**
+ * Sets the values of multiple keys in a Redis cluster, like `MSET`, but for keys that may be
+ * distributed across different hash slots and shards. The keys are grouped by hash slot, and
+ * one `MSET` sub-command is sent for each group, with the sub-commands pipelined to each shard
+ * and the shards queried in parallel. Note, that unlike `MSET` on a single node, the update is
+ * atomic only for keys that share a hash slot.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param entries     The keys and the values to set for them.
+ * @param n           The number of entries.
+ * @return            X_SUCCESS (0) if successful, or X_INCOMPLETE if some, but not all, of the
+ *                    keys could not be set, or else another error code &lt;0.
+ *
+ * @sa redisxClusterMGet()
+ * @sa redisxClusterDelete()
+ */
+int redisxClusterMSet(RedisCluster *cluster, const RedisEntry *entries, int n) {
+  static const char *fn = "redisxClusterMSet";
+
+  RedisMultiKeyRequest req = { "MSET", NULL, NULL, 2, FALSE, NULL };
+  const char **args;
+  int *lengths;
+  int i, status;
+
+  if(!entries) return x_error(X_NULL, EINVAL, fn, "input entries is NULL");
+  if(n < 1) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of entries: %d", n);
+
+  args = (const char **) malloc(2 * n * sizeof(char *));
+  if(!args) return x_error(X_FAILURE, errno, fn, "alloc error (%d char *)", 2 * n);
+
+  lengths = (int *) malloc(2 * n * sizeof(int));
+  if(!lengths) {
+    free(args);
+    return x_error(X_FAILURE, errno, fn, "alloc error (%d int)", 2 * n);
+  }
+
+  for(i = 0; i < n; i++) {
+    args[2 * i] = entries[i].key;
+    lengths[2 * i] = 0;
+    args[2 * i + 1] = entries[i].value;
+    lengths[2 * i + 1] = entries[i].length;
+  }
+
+  req.args = args;
+  req.lengths = lengths;
+
+  status = rClusterScatterGather(cluster, &req, n, rGatherOK, NULL);
+
+  free(lengths);
+  free(args);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+/**
+ * Deletes multiple keys from a Redis cluster, like `DEL`, but for keys that may be distributed
+ * across different hash slots and shards. The keys are grouped by hash slot, and one `DEL`
+ * sub-command is sent for each group, with the sub-commands pipelined to each shard and the
+ * shards queried in parallel.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param keys        The Redis keys to delete.
+ * @param n           The number of keys.
+ * @return            The number of keys that were deleted (&gt;=0) if successful, or X_INCOMPLETE
+ *                    if the deletion failed for some, but not all, of the keys, or else another
+ *                    error code &lt;0.
+ *
+ * @sa redisxClusterMGet()
+ * @sa redisxClusterMSet()
+ */
+int redisxClusterDelete(RedisCluster *cluster, const char **keys, int n) {
+  RedisMultiKeyRequest req = { "DEL", keys, NULL, 1, FALSE, NULL };
+  int deleted = 0;
+
+  prop_error("redisxClusterDelete", rClusterScatterGather(cluster, &req, n, rGatherCount, &deleted));
+  return deleted;
+}
+
+/// \cond PRIVATE
+
+/**
+ * The state of a `SCAN` on one master of a cluster, as part of a cluster-wide scan.
+ */
+typedef struct {
+  Redis *redis;                 ///< The master being scanned
+  RedisClient *cl;              ///< The interactive client locked for the scan, or NULL
+  char *cursor;                 ///< The cursor for the next page
+  char countArg[20];            ///< String representation of the COUNT argument, or empty if not set.
+  boolean inFlight;             ///< Whether the request for the next page has been sent already
+  boolean done;                 ///< Whether the scan on this master has completed (or failed)
+  int status;                   ///< X_SUCCESS (0) or the error that stopped the scan on this master.
+} RedisShardScan;
+
+/**
+ * Function that processes a page of keys scanned on a cluster master.
+ *
+ * @param redis     The master the keys were scanned on
+ * @param keys      The keys (RESP_BULK_STRING components). The function may take ownership of (and clear)
+ *                  their values.
+ * @param n         The number of keys.
+ * @param ctx       User data
+ * @return          X_SUCCESS (0) to continue scanning, or else a non-zero value to stop the scan.
+ */
+typedef int (*RedisScanFunction)(Redis *redis, RESP **keys, int n, void *ctx);
+
+/**
+ * Requests the next page of keys from a cluster master.
+ *
+ * @param s         The scan state of the master
+ * @param pattern   Glob pattern of the keys to match, or NULL to match all keys.
+ * @return          X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+static int rShardScanSendAsync(RedisShardScan *s, const char *pattern) {
+  const char *args[6];
+  int n = 0;
+
+  args[n++] = "SCAN";
+  args[n++] = s->cursor;
+
+  if(pattern) {
+    args[n++] = "MATCH";
+    args[n++] = pattern;
+  }
+
+  if(s->countArg[0]) {
+    args[n++] = "COUNT";
+    args[n++] = s->countArg;
+  }
+
+  prop_error("rShardScanSendAsync", redisxSendArrayRequestAsync(s->cl, args, NULL, n));
+  s->inFlight = TRUE;
+  return X_SUCCESS;
+}
+
+/**
+ * Reads the next page of keys from a cluster master, and requests the page after it right away, so the
+ * master can work on it while the caller processes the keys.
+ *
+ * @param s         The scan state of the master
+ * @param pattern   Glob pattern of the keys to match, or NULL to match all keys.
+ * @return          The reply containing the page, or NULL if there was an error (the status of the scan
+ *                  state is set).
+ */
+static RESP *rShardScanNextAsync(RedisShardScan *s, const char *pattern) {
+  RESP *reply, **components = NULL;
+  int status = X_SUCCESS;
+
+  s->inFlight = FALSE;
+  reply = redisxReadReplyAsync(s->cl, &status);
+
+  // We expect an array of 2 elements { cursor, { keys } }
+  if(!status) status = redisxCheckRESP(reply, RESP_ARRAY, 2);
+  if(!status) {
+    components = (RESP **) reply->value;
+    status = redisxCheckRESP(components[0], RESP_BULK_STRING, 0);
+    if(!status) status = redisxCheckRESP(components[1], RESP_ARRAY, 0);
+  }
+
+  if(!status) {
+    free(s->cursor);
+    s->cursor = (char *) components[0]->value;
+    components[0]->value = NULL;        // de-reference cursor from RESP.
+
+    s->done = (strcmp(s->cursor, SCAN_INITIAL_CURSOR) == 0);
+    if(!s->done) status = rShardScanSendAsync(s, pattern);
+  }
+
+  if(status) {
+    redisxDestroyRESP(reply);
+    s->status = x_trace("rShardScanNextAsync", s->redis->id, status);
+    s->done = TRUE;
+    return NULL;
+  }
+
+  return reply;
+}
+
+/**
+ * Ends the scan on a cluster master, releasing its interactive client, if it is still locked for the scan.
+ *
+ * @param s         The scan state of the master
+ */
+static void rEndShardScan(RedisShardScan *s) {
+  if(!s->cl) return;
+
+  // Consume the reply to the request still in flight, if any.
+  if(s->inFlight) redisxIgnoreReplyAsync(s->cl);
+  s->inFlight = FALSE;
+
+  redisxUnlockClient(s->cl);
+  s->cl = NULL;
+}
+
+/**
+ * Waits until a page of keys can be read from at least one of the masters still being scanned, and marks
+ * the masters that have a page ready in their poll descriptors. Pages that are already in a client's input
+ * buffer are ready without waiting. If nothing arrives within the client timeouts, all remaining masters are
+ * marked, so the reads that follow fail with the timeout on their own.
+ *
+ * @param scans     The scan states of the masters
+ * @param pfd       Poll descriptors, one for each master, in which the ready masters are marked.
+ * @param n         The number of masters
+ */
+static void rWaitForScanPages(const RedisShardScan *scans, struct pollfd *pfd, int n) {
+  int i, timeout = 0;
+  boolean ready = FALSE, forever = FALSE;
+
+  for(i = 0; i < n; i++) {
+    const ClientPrivate *c;
+
+    pfd[i].fd = -1;             // poll() ignores negative descriptors
+    pfd[i].events = POLLIN;
+    pfd[i].revents = 0;
+
+    if(scans[i].done) continue;
+
+    c = (ClientPrivate *) scans[i].cl->priv;
+
+    // Buffered data, or a closed connection, can be read (or fail) without waiting.
+    if(c->next < c->available || c->socket < 0) {
+      pfd[i].revents = POLLIN;
+      ready = TRUE;
+      continue;
+    }
+
+    pfd[i].fd = c->socket;
+
+    if(c->timeoutMillis <= 0) forever = TRUE;
+    else if(c->timeoutMillis > timeout) timeout = c->timeoutMillis;
+  }
+
+  if(ready) return;
+  if(poll(pfd, n, forever ? -1 : timeout) > 0) return;
+
+  // Timeout or error: let the reads deal with it.
+  for(i = 0; i < n; i++) if(!scans[i].done) pfd[i].revents = POLLIN;
+}
+
+/**
+ * Scans the keys on all masters of a cluster concurrently. The first page is requested from all masters at
+ * once, and thereafter the next page is requested from each master as soon as a page arrives from it. Pages
+ * are read in the order they arrive, whichever master they come from, so all masters work on the scan at the
+ * same time, and the scan takes about as long as that of the largest shard, rather than of all shards
+ * combined. Pages are processed in the calling thread, one at a time.
+ *
+ * An interactive client of each master is locked while the cluster configuration is held, which keeps the
+ * master from being destroyed by a reconfiguration while it is being scanned, but the cluster itself is not
+ * locked during the scan. Each client is released as soon as the scan on its master completes or fails, so a
+ * reconfiguration that drops a master waits only for the part of the scan on that master.
+ *
+ * @param cluster   Pointer to a Redis cluster configuration
+ * @param pattern   Glob pattern of the keys to match, or NULL to match all keys.
+ * @param f         The function to process each page of keys
+ * @param ctx       User data to pass to the processing function
+ * @return          X_SUCCESS (0) if successful, X_INCOMPLETE if the scan failed on some, but not all, of the
+ *                  masters, or else an error code &lt;0 if it failed on all.
+ */
+static int rClusterScan(RedisCluster *cluster, const char *pattern, RedisScanFunction f, void *ctx) {
+  static const char *fn = "rClusterScan";
+
+  ClusterPrivate *cp;
+  RedisShardScan *scans;
+  struct pollfd *pfd;
+  int i, n, active = 0, n_failed = 0, status = X_SUCCESS;
+  boolean stop = FALSE;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  pthread_mutex_lock(&cp->mutex);
+
+  n = cp->n_shards;
+  if(n < 1) {
+    pthread_mutex_unlock(&cp->mutex);
+    return x_error(X_NO_SERVICE, ENOTCONN, fn, "cluster has no shards");
+  }
+
+  scans = (RedisShardScan *) calloc(n, sizeof(RedisShardScan));
+  pfd = (struct pollfd *) calloc(n, sizeof(struct pollfd));
+  if(!scans || !pfd) {
+    pthread_mutex_unlock(&cp->mutex);
+    if(scans) free(scans);
+    if(pfd) free(pfd);
+    return x_error(X_FAILURE, errno, fn, "alloc error (%d RedisShardScan)", n);
+  }
+
+  // Take the current masters.
+  for(i = 0; i < n; i++) {
+    RedisShardScan *s = &scans[i];
+
+    s->done = TRUE;
+    s->status = X_NO_SERVICE;
+
+    if(cp->shard[i].n_servers > 0) s->redis = rGetConnectedServer(cp, cp->shard[i].redis[0]);
+  }
+
+  // Lock an interactive client of each master. We must not wait for a busy client while holding the
+  // cluster lock, which a reconfiguration needs to destroy the masters it drops. So masters whose clients
+  // are all busy are tried again after releasing the cluster lock for a moment, provided they are still
+  // in the cluster by then.
+  for(;;) {
+    const struct timespec nap = { 0, SCAN_RETRY_NANOS };
+    boolean busy = FALSE;
+
+    for(i = 0; i < n; i++) {
+      RedisShardScan *s = &scans[i];
+
+      if(!s->redis || s->cl) continue;
+
+      if(!rHasServer(cp->shard, cp->n_shards, s->redis) || !redisxIsConnected(s->redis)) s->redis = NULL;
+      else if((s->cl = rTryLockInteractive(s->redis)) == NULL) busy = TRUE;
+    }
+
+    if(!busy) break;
+
+    pthread_mutex_unlock(&cp->mutex);
+    nanosleep(&nap, NULL);
+    pthread_mutex_lock(&cp->mutex);
+  }
+
+  pthread_mutex_unlock(&cp->mutex);
+
+  // Request the first page from every master.
+  for(i = 0; i < n; i++) {
+    RedisShardScan *s = &scans[i];
+    int count;
+
+    if(!s->cl) continue;
+
+    count = redisxGetScanCount(s->redis);
+    if(count > 0) sprintf(s->countArg, "%d", count);
+
+    s->cursor = xStringCopyOf(SCAN_INITIAL_CURSOR);
+    s->status = rShardScanSendAsync(s, pattern);
+    if(s->status) {
+      rEndShardScan(s);
+      continue;
+    }
+
+    s->done = FALSE;
+    active++;
+  }
+
+  // Collect pages as they arrive, keeping a request in flight on each master until its scan completes.
+  while(active > 0 && !stop) {
+    rWaitForScanPages(scans, pfd, n);
+
+    for(i = 0; i < n && !stop; i++) {
+      RedisShardScan *s = &scans[i];
+      RESP *reply;
+
+      if(s->done || !pfd[i].revents) continue;
+
+      reply = rShardScanNextAsync(s, pattern);
+
+      if(reply) {
+        RESP *keys = ((RESP **) reply->value)[1];
+        if(f(s->redis, (RESP **) keys->value, keys->n, ctx) != X_SUCCESS) stop = TRUE;
+        redisxDestroyRESP(reply);
+      }
+
+      // Release the master as soon as we are done with it.
+      if(s->done) {
+        rEndShardScan(s);
+        active--;
+      }
+    }
+  }
+
+  // Clean up.
+  for(i = 0; i < n; i++) {
+    RedisShardScan *s = &scans[i];
+
+    rEndShardScan(s);
+    if(s->cursor) free(s->cursor);
+
+    if(s->status) {
+      n_failed++;
+      if(!status) status = s->status;
+    }
+  }
+
+  free(pfd);
+  free(scans);
+
+  if(n_failed == 0) return X_SUCCESS;
+  if(n_failed < n) return x_error(X_INCOMPLETE, EAGAIN, fn, "scan failed on %d of %d masters", n_failed, n);
+
+  prop_error(fn, status);
+  return status;
+}
+
+/**
+ * Keys collected from a cluster-wide scan.
+ */
+typedef struct {
+  char **keys;                  ///< Array of keys collected
+  int n;                        ///< Number of keys collected
+  int capacity;                 ///< Number of keys that fit in the array
+} RedisKeyList;
+
+/**
+ * Adds a page of scanned keys to a key list, taking over their values.
+ *
+ * @param redis     (unused) The master the keys were scanned on
+ * @param keys      The keys (RESP_BULK_STRING components)
+ * @param n         The number of keys
+ * @param ctx       Pointer to the RedisKeyList to add to
+ * @return          X_SUCCESS (0)
+ */
+static int rCollectKeys(Redis *redis, RESP **keys, int n, void *ctx) {
+  RedisKeyList *list = (RedisKeyList *) ctx;
+  int i;
+
+  (void) redis;
+
+  if(list->n + n > list->capacity) {
+    if(list->capacity < 1) list->capacity = 1;
+    while(list->n + n > list->capacity) list->capacity <<= 1;
+    list->keys = (char **) realloc(list->keys, list->capacity * sizeof(char *));
+    x_check_alloc(list->keys);
+  }
+
+  for(i = 0; i < n; i++) if(redisxCheckRESP(keys[i], RESP_BULK_STRING, 0) == X_SUCCESS) {
+    list->keys[list->n++] = (char *) keys[i]->value;
+    keys[i]->value = NULL;      // de-reference key from RESP.
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * A user function and its data for streaming the keys of a cluster-wide scan.
+ */
+typedef struct {
+  RedisKeyProcessor f;          ///< The user function to call with each page of keys
+  void *ptr;                    ///< The user data to pass along
+  const char **keys;            ///< Buffer for the key names of a page
+  int capacity;                 ///< Number of key names that fit in the buffer
+  int total;                    ///< Total number of keys passed to the user function
+} RedisKeyStream;
+
+/**
+ * Passes a page of scanned keys to the user's key processor function.
+ *
+ * @param redis     The master the keys were scanned on
+ * @param keys      The keys (RESP_BULK_STRING components)
+ * @param n         The number of keys
+ * @param ctx       Pointer to the RedisKeyStream
+ * @return          The return value of the user function.
+ */
+static int rStreamKeys(Redis *redis, RESP **keys, int n, void *ctx) {
+  RedisKeyStream *stream = (RedisKeyStream *) ctx;
+  int i, k = 0;
+
+  if(n < 1) return X_SUCCESS;
+
+  if(n > stream->capacity) {
+    while(n > stream->capacity) stream->capacity = stream->capacity > 0 ? stream->capacity << 1 : n;
+    stream->keys = (const char **) realloc(stream->keys, stream->capacity * sizeof(char *));
+    x_check_alloc(stream->keys);
+  }
+
+  for(i = 0; i < n; i++) if(redisxCheckRESP(keys[i], RESP_BULK_STRING, 0) == X_SUCCESS) stream->keys[k++] = (char *) keys[i]->value;
+
+  stream->total += k;
+  return stream->f(redis, stream->keys, k, stream->ptr);
+}
+
+/// \endcond
+
+/**
+ * Returns an alphabetical list of the keys on all shards of a cluster, using the Redis `SCAN` command on every
+ * master concurrently. Each master is scanned over its own (interactive) connection, with the request for its
+ * next page sent as soon as a page arrives, so walking the entire keyspace takes about as long as scanning the
+ * largest shard alone. The keys are merged into a single sorted list, with duplicates removed.
+ *
+ * An interactive client of each master is locked until the scan on that master completes. The cluster may be
+ * reconfigured meanwhile (e.g. after a `MOVED` redirection), but a master that is dropped from the cluster stops its
+ * part of the scan with an error, and the keys from the other masters are returned with an X_INCOMPLETE status. Keys
+ * whose slots migrate to a different shard while the scan is in progress may be missed or returned twice (the latter is
+ * deduplicated). The COUNT argument used on each master is the one set by redisxSetScanCount() for that master.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param pattern     Glob pattern of the keys to match, or NULL to match all keys.
+ * @param[out] n      Pointer to the integer in which the number of keys returned (&gt;=0) is returned, or else an
+ *                    error code (&lt;0) if the scan failed on all masters.
+ * @param[out] status (optional) pointer in which to return X_SUCCESS (0) if successful, or X_INCOMPLETE if the
+ *                    scan failed on some, but not all, of the masters, or else another error code &lt;0.
+ * @return            An array with the unique, alphabetically sorted keys (only those from the masters that
+ *                    could be scanned, if the scan is incomplete), which should be destroyed with
+ *                    redisxDestroyKeys() after use, or NULL if no keys were found, or if the scan failed on all
+ *                    masters (`n` indicates the error).
+ *
+ * @sa redisxClusterStreamKeys()
+ * @sa redisxScanKeys()
+ * @sa redisxDestroyKeys()
+ */
+char **redisxClusterScanKeys(RedisCluster *cluster, const char *pattern, int *n, int *status) {
+  static const char *fn = "redisxClusterScanKeys";
+
+  RedisKeyList list = {0};
+  int s;
+
+  if(n == NULL) {
+    x_error(0, EINVAL, fn, "parameter 'n' is NULL");
+    if(status) *status = X_NULL;
+    return NULL;
+  }
+
+  s = rClusterScan(cluster, pattern, rCollectKeys, &list);
+  if(status) *status = s;
+
+  if(s != X_SUCCESS && s != X_INCOMPLETE) {
+    redisxDestroyKeys(list.keys, list.n);
+    *n = s;
+    return x_trace_null(fn, NULL);
+  }
+
+  if(!list.keys) {
+    *n = 0;
+    return NULL;
+  }
+
+  *n = rSortKeys(list.keys, list.n);
+
+  xvprintf("Redis-X> Returning %d keys scanned on cluster.\n", *n);
+
+  return list.keys;
+}
+
+/**
+ * Streams the keys on all shards of a cluster, as they are scanned on every master concurrently (see
+ * redisxClusterScanKeys()), without collecting the entire keyspace in memory. The keys are passed to the
+ * processor function one page at a time, in the order the pages arrive from the masters. The processor function
+ * is called from the calling thread only, so it need not be thread-safe.
+ *
+ * Since an interactive client of each master is locked while it is scanned, the processor function should not make
+ * interactive requests to the cluster (other than via a pool of interactive clients, if configured), but it may
+ * use pipelined requests. Unlike with redisxClusterScanKeys(), the same key may be passed more than once.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param pattern     Glob pattern of the keys to match, or NULL to match all keys.
+ * @param f           The function to call with each page of keys. It may return a non-zero value to stop the
+ *                    scan early.
+ * @param ptr         User data to pass to the processor function.
+ * @return            The total number of keys (&gt;=0) passed to the processor function if successful, or else
+ *                    X_INCOMPLETE if the scan failed on some, but not all, masters, or another error code
+ *                    &lt;0.
+ *
+ * @sa redisxClusterScanKeys()
+ */
+int redisxClusterStreamKeys(RedisCluster *cluster, const char *pattern, RedisKeyProcessor f, void *ptr) {
+  static const char *fn = "redisxClusterStreamKeys";
+
+  RedisKeyStream stream = { f, ptr, NULL, 0, 0 };
+  int status;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "processor function is NULL");
+
+  status = rClusterScan(cluster, pattern, rStreamKeys, &stream);
+  if(stream.keys) free(stream.keys);
+
+  prop_error(fn, status);
+  return stream.total;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Handles the loss of sharded subscriptions on a cluster server, e.g. when the server unsubscribes a channel
+ * because its hash slot migrated to another shard. The affected channels are marked as not subscribed, and
+ * the cluster configuration is reloaded, after which the channels are subscribed again on the shards that
+ * now serve them. Unsubscriptions requested by the user are ignored.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param redis       The server on which the subscriptions were lost
+ * @param channel     The channel that was unsubscribed, or NULL if all channels on the server are affected.
+ */
+void rClusterShardUnsubscribed(RedisCluster *cluster, Redis *redis, const char *channel) {
+  ClusterPrivate *cp = (ClusterPrivate *) cluster->priv;
+  RedisShardChannel *c;
+  boolean lost = FALSE;
+
+  if(!cp) return;
+
+  pthread_mutex_lock(&cp->pubsubLock);
+  for(c = cp->channels; c; c = c->next) if(c->server == redis && (!channel || strcmp(channel, c->name) == 0)) {
+    c->server = NULL;
+    lost = TRUE;
+  }
+  if(lost) rPruneShardHosts(cp);
+  pthread_mutex_unlock(&cp->pubsubLock);
+
+  if(lost) {
+    xvprintf("Redis-X> Lost sharded subscription(s) on %s. Reconfiguring...\n", redis->id);
+    rClusterRefresh(cluster);
+  }
+}
+
+/// \endcond
+
+/**
+ * Adds a subscriber callback for sharded PUB/SUB messages on a cluster. The callback is called for messages
+ * on all sharded channels, subscribed via redisxClusterSubscribe(), whose name begins with the specified
+ * stem. It is called from the subscription listener (or dispatch workers) of the shard that received the
+ * message, so with multiple shards it may be called concurrently.
+ *
+ * @param cluster       Pointer to a Redis cluster configuration
+ * @param channelStem   Channel stem, or NULL to receive messages on all subscribed channels.
+ * @param f             A function that consumes subscription messages.
+ * @return              X_SUCCESS (0) if successful, or else an error code &lt;0 (errno will also
+ *                      indicate the type of error).
+ *
+ * @sa redisxClusterRemoveSubscribers()
+ * @sa redisxClusterSubscribe()
+ * @sa redisxAddSubscriber()
+ */
+int redisxClusterAddSubscriber(RedisCluster *cluster, const char *channelStem, RedisSubscriberCall f) {
+  static const char *fn = "redisxClusterAddSubscriber";
+
+  ClusterPrivate *cp;
+  MessageConsumer *c;
+  int i;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+  if(!f) return x_error(X_NULL, EINVAL, fn, "subscriber function is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  pthread_mutex_lock(&cp->pubsubLock);
+
+  for(c = cp->subscribers; c; c = c->next) {
+    if(c->func != f) continue;
+    if(channelStem ? (c->channelStem && strcmp(channelStem, c->channelStem) == 0) : !c->channelStem) break;
+  }
+
+  if(!c) {
+    c = (MessageConsumer *) calloc(1, sizeof(MessageConsumer));
+    x_check_alloc(c);
+
+    c->func = f;
+    c->channelStem = xStringCopyOf(channelStem);
+    c->next = cp->subscribers;
+    cp->subscribers = c;
+
+    // Add to the servers that have subscriptions already.
+    for(i = 0; i < cp->n_hosts; i++) rAddSubscriber(cp->hosts[i], channelStem, f, cp);
+  }
+
+  pthread_mutex_unlock(&cp->pubsubLock);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Removes all instances of a subscriber callback for sharded PUB/SUB messages on a cluster, from all
+ * servers it was registered on. The same callback, if added directly to any of the servers via
+ * redisxAddSubscriber(), remains active there.
+ *
+ * @param cluster       Pointer to a Redis cluster configuration
+ * @param f             The subscriber function to remove.
+ * @return              The number of instances removed, or else an error code &lt;0 (errno will also
+ *                      indicate the type of error).
+ *
+ * @sa redisxClusterAddSubscriber()
+ * @sa redisxClusterUnsubscribe()
+ */
+int redisxClusterRemoveSubscribers(RedisCluster *cluster, RedisSubscriberCall f) {
+  static const char *fn = "redisxClusterRemoveSubscribers";
+
+  ClusterPrivate *cp;
+  MessageConsumer **pc;
+  int i, n = 0;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  pthread_mutex_lock(&cp->pubsubLock);
+
+  for(pc = &cp->subscribers; *pc; ) {
+    MessageConsumer *c = *pc;
+
+    if(c->func != f) {
+      pc = &c->next;
+      continue;
+    }
+
+    *pc = c->next;
+    if(c->channelStem) free(c->channelStem);
+    free(c);
+    n++;
+  }
+
+  // Remove from all servers it was added to, leaving any that were added there by others.
+  if(n) for(i = 0; i < cp->n_hosts; i++) rRemoveSubscribers(cp->hosts[i], f, cp);
+
+  pthread_mutex_unlock(&cp->pubsubLock);
+
+  return n;
+}
+
+/**
+ * Subscribes to a sharded PUB/SUB channel (`SSUBSCRIBE`) on a cluster. The subscription is made on the
+ * master of the shard serving the channel's hash slot, via the subscription client of that server, so
+ * messages are not broadcast across the cluster bus. If the slot migrates to another shard later, the
+ * channel is subscribed again automatically on the shard that serves it after the cluster is reconfigured.
+ * Use redisxClusterAddSubscriber() to process the messages received.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param channel     The sharded channel to subscribe to. Unlike with redisxSubscribe(), globbing patterns
+ *                    are not supported.
+ * @return            X_SUCCESS (0) if successful, or else an error code &lt;0 (errno will also
+ *                    indicate the type of error).
+ *
+ * @sa redisxClusterUnsubscribe()
+ * @sa redisxClusterAddSubscriber()
+ * @sa redisxClusterPublish()
+ */
+int redisxClusterSubscribe(RedisCluster *cluster, const char *channel) {
+  static const char *fn = "redisxClusterSubscribe";
+
+  ClusterPrivate *cp;
+  RedisShardChannel *c;
+  const RedisShard *s;
+  int status = X_SUCCESS;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+  if(!channel) return x_error(X_NULL, EINVAL, fn, "channel is NULL");
+  if(!*channel) return x_error(X_NAME_INVALID, EINVAL, fn, "channel is empty");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  // Lock the configuration, so the shard serving the channel does not change meanwhile.
+  pthread_mutex_lock(&cp->mutex);
+  pthread_mutex_lock(&cp->pubsubLock);
+
+  for(c = cp->channels; c; c = c->next) if(strcmp(channel, c->name) == 0) break;
+
+  if(!c) {
+    c = (RedisShardChannel *) calloc(1, sizeof(RedisShardChannel));
+    x_check_alloc(c);
+    c->name = xStringCopyOf(channel);
+    c->next = cp->channels;
+    cp->channels = c;
+  }
+
+  s = cp->slotMap ? cp->slotMap->shard[rCalcHash(channel) & HASH_MASK] : NULL;
+
+  if(!s) status = x_error(X_NO_SERVICE, EAGAIN, fn, "no shard serves channel %s", channel);
+  else if(c->server != s->redis[0]) {
+    status = rShardSubscribeAsync(cp, s->redis[0], channel);
+    if(!status) c->server = s->redis[0];
+    else rPruneShardHosts(cp);
+  }
+
+  pthread_mutex_unlock(&cp->pubsubLock);
+  pthread_mutex_unlock(&cp->mutex);
+
+  prop_error(fn, status);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Unsubscribes from one or all sharded PUB/SUB channels on a cluster (`SUNSUBSCRIBE`). The subscriber
+ * callbacks remain registered until redisxClusterRemoveSubscribers() is called to deactivate them as
+ * appropriate.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param channel     The sharded channel, or NULL to unsubscribe from all sharded channels.
+ * @return            X_SUCCESS (0) if successful, or else an error code &lt;0 (errno will also
+ *                    indicate the type of error).
+ *
+ * @sa redisxClusterSubscribe()
+ */
+int redisxClusterUnsubscribe(RedisCluster *cluster, const char *channel) {
+  static const char *fn = "redisxClusterUnsubscribe";
+
+  ClusterPrivate *cp;
+  RedisShardChannel **pc;
+
+  if(!cluster) return x_error(X_NULL, EINVAL, fn, "cluster is NULL");
+
+  cp = (ClusterPrivate *) cluster->priv;
+  if(!cp) return x_error(X_NO_INIT, ENXIO, fn, "cluster is not initialized");
+
+  pthread_mutex_lock(&cp->pubsubLock);
+
+  for(pc = &cp->channels; *pc; ) {
+    RedisShardChannel *c = *pc;
+
+    if(channel && strcmp(channel, c->name) != 0) {
+      pc = &c->next;
+      continue;
+    }
+
+    // Remove from the list before unsubscribing, so the confirmation is not mistaken for a migration.
+    *pc = c->next;
+    if(c->server) rShardUnsubscribe(c->server, c->name);
+
+    free(c->name);
+    free(c);
+  }
+
+  rPruneShardHosts(cp);
+
+  pthread_mutex_unlock(&cp->pubsubLock);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Publishes a message on a sharded PUB/SUB channel of a cluster (`SPUBLISH`). The message is sent to the
+ * shard serving the channel's hash slot, and is delivered only to the subscribers of that shard, rather
+ * than being broadcast to all cluster nodes. If the channel has moved to another shard, the message is
+ * published again on the shard it was redirected to.
+ *
+ * @param cluster     Pointer to a Redis cluster configuration
+ * @param channel     The sharded channel on which to publish
+ * @param data        Message data
+ * @param length      Bytes of message data to send, or 0 to determine automatically with strlen().
+ * @return            X_SUCCESS (0) if successful, or else an error code &lt;0 (errno will also
+ *                    indicate the type of error).
+ *
+ * @sa redisxClusterSubscribe()
+ * @sa redisxPublish()
+ */
+int redisxClusterPublish(RedisCluster *cluster, const char *channel, const char *data, int length) {
+  static const char *fn = "redisxClusterPublish";
+
+  const char *args[3];
+  int L[3] = {0};
+  Redis *redis;
+  RESP *reply;
+  int status = X_SUCCESS;
+
+  if(!channel) return x_error(X_NULL, EINVAL, fn, "channel is NULL");
+  if(!*channel) return x_error(X_NAME_INVALID, EINVAL, fn, "channel is empty");
+  if(!data) return x_error(X_NULL, EINVAL, fn, "data is NULL");
+
+  redis = redisxClusterGetShard(cluster, channel);
+  if(!redis) return x_trace(fn, NULL, X_NO_SERVICE);
+
+  args[0] = "SPUBLISH";
+  args[1] = channel;
+  args[2] = data;
+  L[2] = length > 0 ? length : (int) strlen(data);
+
+  reply = redisxArrayRequest(redis, args, L, 3, &status);
+
+  if(!status && redisxClusterMoved(reply)) {
+    // Try again on the shard that now serves the channel.
+    redis = redisxClusterGetRedirection(cluster, reply, TRUE);
+    redisxDestroyRESP(reply);
+    reply = NULL;
+
+    if(redis) reply = redisxArrayRequest(redis, args, L, 3, &status);
+    else status = X_NO_SERVICE;
+  }
+
+  if(!status) status = redisxCheckDestroyRESP(reply, RESP_INT, 0);
+  else redisxDestroyRESP(reply);
+
+  prop_error(fn, status);
+
+  return X_SUCCESS;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ *
+ *   Futures for pipelined requests. A future is a handle to the eventual reply of a request sent on the
+ *   pipeline client, which is fulfilled by the pipeline listener when the reply arrives. Callers may poll
+ *   futures, or wait for one, any, or all of a set of them, with an optional timeout.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "redisx-priv.h"
+
+/// \cond PRIVATE
+
+/**
+ * The state of a future. Futures are reference counted: one reference is held by the caller, until
+ * redisxDestroyFuture() is called, and another by the pending request, until the reply arrives.
+ */
+struct RedisFuture {
+  RESP *reply;                  ///< The reply, once received, until it is taken.
+  int status;                   ///< X_SUCCESS, or X_NO_SERVICE if the request was not answered.
+  boolean isDone;               ///< Whether the future has been fulfilled.
+  int refs;                     ///< Number of references held to the future.
+};
+
+/// \endcond
+
+// A single lock and condition for all futures, so we may wait for any of a set of futures.
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * Releases a reference to a future, and frees it along with any reply not yet taken if it was the last
+ * reference. The caller must hold the mutex.
+ *
+ * \param f     Pointer to a future
+ */
+static void rReleaseFuture(RedisFuture *f) {
+  if(--f->refs > 0) return;
+  redisxDestroyRESP(f->reply);
+  free(f);
+}
+
+/**
+ * Fulfills a future with the reply that arrived for its request. It is called by the pipeline listener
+ * via the request's completion.
+ *
+ * \param reply     The reply to the request, or NULL if the request was not answered.
+ * \param arg       Pointer to the future
+ */
+static void rFulfillFuture(RESP *reply, void *arg) {
+  RedisFuture *f = (RedisFuture *) arg;
+  RESP *own = NULL;
+
+  if(reply) {
+    // Take over the reply's contents, leaving behind an empty shell for the listener to destroy.
+    own = (RESP *) malloc(sizeof(RESP));
+    if(own) {
+      *own = *reply;
+      reply->value = NULL;
+    }
+    else fprintf(stderr, "WARNING! Redis-X : not enough memory for future reply. Skipping.\n");
+  }
+
+  pthread_mutex_lock(&mutex);
+  f->reply = own;
+  f->status = own ? X_SUCCESS : X_NO_SERVICE;
+  f->isDone = TRUE;
+  rReleaseFuture(f);
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+}
+
+/**
+ * Sends a request on the pipeline client of a Redis instance, and returns a future, which will be fulfilled
+ * with the reply when it arrives. You can check if the reply has arrived via redisxIsFutureDone(), or wait for
+ * it via redisxWaitFuture(), or for a set of futures via redisxWaitAllFutures() or redisxWaitAnyFuture(). Once
+ * the future is done, you can obtain the reply via redisxTakeFutureReply(). Either way, you should call
+ * redisxDestroyFuture() once you no longer need the future.
+ *
+ * Unlike redisxArrayRequest() the call does not wait for the reply, and unlike redisxSendArrayRequestAsync() you do not
+ * have to keep track of which reply belongs to which request yourself. This way, you can fire off many requests in a
+ * row, and collect their replies afterwards.
+ *
+ * \param redis         Pointer to a Redis instance, connected with the pipeline enabled.
+ * \param args          The array of string arguments to send.
+ * \param lengths       Array indicating the number of bytes to send from each string argument, or NULL to
+ *                      use strlen() for all arguments (see redisxSendArrayRequestAsync()).
+ * \param n             The number of arguments to send.
+ * \param pStatus       (optional) Pointer to int in which to return an error status, such as X_NULL if the
+ *                      Redis instance is NULL, or X_NO_SERVICE if the pipeline is not connected or if the
+ *                      request could not be sent. It may be NULL if not required.
+ *
+ * \return              A future for the reply, or NULL if the request could not be sent.
+ *
+ * @sa redisxDestroyFuture()
+ * @sa redisxSendRequestCb()
+ */
+RedisFuture *redisxSendRequestFuture(Redis *redis, const char **args, const int *lengths, int n, int *pStatus) {
+  static const char *fn = "redisxSendRequestFuture";
+
+  RedisFuture *f = (RedisFuture *) calloc(1, sizeof(RedisFuture));
+  int status;
+
+  x_check_alloc(f);
+  f->refs = 2;      // One for the caller, and one for the pending request.
+
+  status = redisxSendRequestCb(redis, args, lengths, n, rFulfillFuture, f);
+  if(pStatus) *pStatus = status;
+
+  if(status) {
+    free(f);
+    return x_trace_null(fn, NULL);
+  }
+
+  return f;
+}
+
+/**
+ * Checks if a future has been fulfilled, without waiting.
+ *
+ * \param f     Pointer to a future
+ * \return      TRUE (1) if the future is done, or else FALSE (0) if the reply has not arrived yet, or if
+ *              the argument is NULL.
+ *
+ * @sa redisxWaitFuture()
+ */
+boolean redisxIsFutureDone(RedisFuture *f) {
+  boolean isDone;
+
+  if(!f) return FALSE;
+
+  pthread_mutex_lock(&mutex);
+  isDone = f->isDone;
+  pthread_mutex_unlock(&mutex);
+
+  return isDone;
+}
+
+/**
+ * Calculates the absolute deadline for a timed wait.
+ *
+ * \param timeoutMillis     [ms] Timeout from now.
+ * \param[out] deadline     The absolute time (CLOCK_REALTIME) of the deadline
+ */
+static void rGetDeadline(int timeoutMillis, struct timespec *deadline) {
+  clock_gettime(CLOCK_REALTIME, deadline);
+  deadline->tv_sec += timeoutMillis / 1000;
+  deadline->tv_nsec += (timeoutMillis % 1000) * 1000000L;
+  if(deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
+
+/**
+ * Waits on the shared condition, with the mutex held, until notified or until the deadline.
+ *
+ * \param deadline      The absolute deadline, or NULL to wait indefinitely.
+ * \return              X_SUCCESS (0) if notified, or X_TIMEDOUT if the deadline has passed.
+ */
+static int rWaitAsync(const struct timespec *deadline) {
+  if(!deadline) pthread_cond_wait(&cond, &mutex);
+  else if(pthread_cond_timedwait(&cond, &mutex, deadline) == ETIMEDOUT) return X_TIMEDOUT;
+  return X_SUCCESS;
+}
+
+/**
+ * Waits for any one of a set of futures to be fulfilled, up to the specified timeout.
+ *
+ * \param futures         Array of futures. It may contain NULL entries, which are ignored.
+ * \param n               Number of futures in the array.
+ * \param timeoutMillis   [ms] Maximum time to wait, or a negative value to wait indefinitely. A zero timeout
+ *                        simply checks the futures without waiting.
+ * \return                The (non-negative) index of a future that is done, or else X_TIMEDOUT if none of the
+ *                        futures were fulfilled within the timeout, or X_NULL if the array is NULL or contains
+ *                        no futures.
+ *
+ * @sa redisxWaitAllFutures()
+ * @sa redisxWaitFuture()
+ */
+int redisxWaitAnyFuture(RedisFuture **futures, int n, int timeoutMillis) {
+  static const char *fn = "redisxWaitAnyFuture";
+
+  struct timespec deadline;
+  int i, idx = X_NULL;
+
+  if(!futures) return x_error(X_NULL, EINVAL, fn, "futures is NULL");
+
+  if(timeoutMillis > 0) rGetDeadline(timeoutMillis, &deadline);
+
+  pthread_mutex_lock(&mutex);
+
+  for(;;) {
+    boolean hasAny = FALSE;
+
+    for(i = 0; i < n; i++) if(futures[i]) {
+      hasAny = TRUE;
+      if(futures[i]->isDone) break;
+    }
+
+    if(i < n) {
+      idx = i;
+      break;
+    }
+
+    if(!hasAny) break;
+
+    if(timeoutMillis == 0 || rWaitAsync(timeoutMillis > 0 ? &deadline : NULL) == X_TIMEDOUT) {
+      idx = X_TIMEDOUT;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if(idx == X_NULL) return x_error(X_NULL, EINVAL, fn, "no futures to wait on");
+  if(idx == X_TIMEDOUT) return x_error(X_TIMEDOUT, ETIMEDOUT, fn, "timed out");
+
+  return idx;
+}
+
+/**
+ * Waits for all of a set of futures to be fulfilled, up to the specified timeout.
+ *
+ * \param futures         Array of futures. It may contain NULL entries, which are ignored.
+ * \param n               Number of futures in the array.
+ * \param timeoutMillis   [ms] Maximum time to wait, or a negative value to wait indefinitely. A zero timeout
+ *                        simply checks the futures without waiting.
+ * \return                X_SUCCESS (0) if all futures are done, or else X_TIMEDOUT if some of the futures
+ *                        were not fulfilled within the timeout, or X_NULL if the array is NULL.
+ *
+ * @sa redisxWaitAnyFuture()
+ * @sa redisxWaitFuture()
+ */
+int redisxWaitAllFutures(RedisFuture **futures, int n, int timeoutMillis) {
+  static const char *fn = "redisxWaitAllFutures";
+
+  struct timespec deadline;
+  int i = 0, status = X_SUCCESS;
+
+  if(!futures) return x_error(X_NULL, EINVAL, fn, "futures is NULL");
+
+  if(timeoutMillis > 0) rGetDeadline(timeoutMillis, &deadline);
+
+  pthread_mutex_lock(&mutex);
+
+  // The done futures stay done, so we can pick up where we left off after each wakeup.
+  while(i < n) {
+    if(!futures[i] || futures[i]->isDone) i++;
+    else if(timeoutMillis == 0 || rWaitAsync(timeoutMillis > 0 ? &deadline : NULL) == X_TIMEDOUT) {
+      status = X_TIMEDOUT;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if(status) return x_error(X_TIMEDOUT, ETIMEDOUT, fn, "timed out with %d of %d futures remaining", n - i, n);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Waits for a future to be fulfilled, up to the specified timeout.
+ *
+ * \param f               Pointer to a future
+ * \param timeoutMillis   [ms] Maximum time to wait, or a negative value to wait indefinitely. A zero timeout
+ *                        simply checks the future without waiting.
+ * \return                X_SUCCESS (0) if the reply has arrived, or else X_TIMEDOUT if the future was not
+ *                        fulfilled within the timeout, X_NO_SERVICE if the request will not be answered because
+ *                        the pipeline was closed, or X_NULL if the future is NULL.
+ *
+ * @sa redisxTakeFutureReply()
+ * @sa redisxIsFutureDone()
+ */
+int redisxWaitFuture(RedisFuture *f, int timeoutMillis) {
+  static const char *fn = "redisxWaitFuture";
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "future is NULL");
+
+  prop_error(fn, redisxWaitAllFutures(&f, 1, timeoutMillis));
+
+  // Status is final once done.
+  if(f->status) return x_error(f->status, ENOTCONN, fn, "request was not answered");
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the reply from a fulfilled future, passing the ownership of the reply to the caller. Subsequent calls
+ * on the same future will return NULL.
+ *
+ * \param f     Pointer to a future
+ * \return      The reply, which the caller should destroy with redisxDestroyRESP() after use, or NULL if the
+ *              future is not done, the reply has already been taken, or if the request was not answered.
+ *
+ * @sa redisxWaitFuture()
+ */
+RESP *redisxTakeFutureReply(RedisFuture *f) {
+  RESP *reply = NULL;
+
+  if(!f) return NULL;
+
+  pthread_mutex_lock(&mutex);
+  if(f->isDone) {
+    reply = f->reply;
+    f->reply = NULL;
+  }
+  pthread_mutex_unlock(&mutex);
+
+  return reply;
+}
+
+/**
+ * Destroys a future, along with its reply if it was not taken. It is safe to call before the future is
+ * fulfilled, in which case the reply will be discarded when it arrives.
+ *
+ * \param f     Pointer to a future. It may be NULL.
+ *
+ * @sa redisxSendRequestFuture()
+ */
+void redisxDestroyFuture(RedisFuture *f) {
+  if(!f) return;
+
+  pthread_mutex_lock(&mutex);
+  rReleaseFuture(f);
+  pthread_mutex_unlock(&mutex);
+}
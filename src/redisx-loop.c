@@ -0,0 +1,433 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ *
+ *   An optional shared event loop for processing responses on the pipeline and subscription clients
+ *   of many Redis instances with a small, fixed number of threads, instead of a dedicated listener
+ *   thread per client. It is based on `epoll(7)`, and is therefore available on Linux only.
+ *
+ *   Each registered client is armed in one-shot mode, so that a client is only ever serviced by a single
+ *   loop thread at a time. When data arrives, the loop thread reads and processes all complete responses
+ *   that are available in the client's receive buffer, before re-arming the client for the next event.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#if __linux__
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#endif
+
+#include "redisx-priv.h"
+
+#if __linux__
+
+/// \cond PRIVATE
+#define LOOP_MAX_EVENTS     64    ///< Maximum number of events to retrieve per epoll_wait() call.
+
+#define LOOP_EVENTS         (EPOLLIN | EPOLLRDHUP | EPOLLONESHOT)  ///< Events we arm clients for.
+/// \endcond
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int epfd = -1;             ///< The shared epoll file descriptor
+static int wakefd = -1;           ///< eventfd to wake loop threads when stopping
+static pthread_t *loopThreads;    ///< Loop threads
+static int nThreads;              ///< Number of loop threads
+static volatile boolean isRunning;
+static __thread boolean isLoopThread;   ///< Whether the calling thread is an event loop thread
+
+/**
+ * Checks if the listener for the given client is (still) enabled.
+ *
+ * \param cl    Pointer to a Redis client
+ * \return      TRUE (1) if the client's responses should be processed by the loop, or else FALSE (0).
+ */
+static boolean rIsListening(const RedisClient *cl) {
+  const ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  const RedisPrivate *p = (RedisPrivate *) cp->redis->priv;
+
+  if(!cp->isEnabled) return FALSE;
+
+  switch(cp->idx) {
+    case REDISX_PIPELINE_CHANNEL: return p->isPipelineListenerEnabled;
+    case REDISX_SUBSCRIPTION_CHANNEL: return p->isSubscriptionListenerEnabled;
+    default: return FALSE;
+  }
+}
+
+/**
+ * Checks if the client has more (possibly partial) response data buffered locally, which will not trigger a
+ * new socket event.
+ *
+ * \param cl    Pointer to a Redis client
+ * \return      TRUE (1) if there is locally buffered data to process, or else FALSE (0).
+ */
+static boolean rHasBufferedData(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  boolean hasData;
+
+  pthread_mutex_lock(&cp->readLock);
+  hasData = cp->next < cp->available;
+#if WITH_TLS
+  if(!hasData && cp->ssl) hasData = SSL_pending(cp->ssl) > 0;
+#endif
+  pthread_mutex_unlock(&cp->readLock);
+
+  return hasData;
+}
+
+/**
+ * Processes incoming responses on a client that has become readable, and re-arms it for the next event
+ * if the client is still enabled.
+ *
+ * \param cl    Pointer to a Redis client
+ */
+static void rServiceClient(RedisClient *cl) {
+  const ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  Redis *redis = cp->redis;
+
+  while(rIsListening(cl)) {
+    RESP *reply;
+
+    // Deliver PUB/SUB messages straight from the receive buffer, where possible.
+    if(cp->idx == REDISX_SUBSCRIPTION_CHANNEL && rReadMessageAsync(cl) != 0) {
+      if(!rHasBufferedData(cl)) break;
+      continue;
+    }
+
+    reply = redisxReadReplyAsync(cl, NULL);
+
+    if(reply) {
+      if(cp->idx == REDISX_PIPELINE_CHANNEL) rProcessPipelineReply(redis, reply);
+      else rProcessSubscriptionReply(redis, reply);
+      redisxDestroyRESP(reply);
+    }
+
+    if(!rHasBufferedData(cl)) break;
+  }
+
+  if(rIsListening(cl)) {
+    struct epoll_event ev = {};
+
+    ev.events = LOOP_EVENTS;
+    ev.data.ptr = cl;
+
+    // The socket may have been closed concurrently, in which case it is no longer in the interest list.
+    if(epoll_ctl(epfd, EPOLL_CTL_MOD, cp->socket, &ev) != 0)
+      xvprintf("Redis-X> event loop: could not re-arm client: %s\n", strerror(errno));
+  }
+  else if(!cp->isEnabled && rConfigLock(redis) == X_SUCCESS) {
+    // The client was closed (e.g. on a read error). Mark the listener as disabled, like the listener threads
+    // do, so it is registered again when the client is reconnected. (Closing the client has removed its
+    // socket from the loop already.)
+    RedisPrivate *p = (RedisPrivate *) redis->priv;
+
+    if(!cp->isEnabled) {
+      if(cp->idx == REDISX_PIPELINE_CHANNEL) p->isPipelineListenerEnabled = FALSE;
+      else p->isSubscriptionListenerEnabled = FALSE;
+    }
+
+    rConfigUnlock(redis);
+  }
+}
+
+/**
+ * The event loop thread routine.
+ *
+ * \param arg   (unused)
+ * \return      Always NULL.
+ */
+static void *RedisEventLoop(void *arg) {
+  struct epoll_event events[LOOP_MAX_EVENTS];
+
+  (void) arg;
+
+  isLoopThread = TRUE;
+
+  xvprintf("Redis-X> Started event loop thread.\n");
+
+  while(isRunning) {
+    int i, n = epoll_wait(epfd, events, LOOP_MAX_EVENTS, -1);
+
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      perror("ERROR! Redis-X : epoll_wait");
+      break;
+    }
+
+    for(i = 0; i < n && isRunning; i++) {
+      if(events[i].data.ptr == NULL) continue;    // wakeup event
+      rServiceClient((RedisClient *) events[i].data.ptr);
+    }
+  }
+
+  xvprintf("Redis-X> Stopped event loop thread.\n");
+
+  return NULL;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Registers a connected pipeline or subscription client with the shared event loop, so its responses will be
+ * processed by the loop threads instead of a dedicated listener thread. The caller should enable the
+ * corresponding listener flag before calling this function.
+ *
+ * \param cl    Pointer to a Redis client (pipeline or subscription).
+ * \return      X_SUCCESS (0) if successful, or else X_NO_INIT if the event loop is not running, or
+ *              X_FAILURE if the client could not be added.
+ */
+int rLoopAddClientAsync(RedisClient *cl) {
+  static const char *fn = "rLoopAddClientAsync";
+
+  const ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  struct epoll_event ev = {};
+  int status = X_SUCCESS;
+
+  ev.events = LOOP_EVENTS;
+  ev.data.ptr = cl;
+
+  pthread_mutex_lock(&mutex);
+
+  if(!isRunning) status = X_NO_INIT;
+  else if(epoll_ctl(epfd, EPOLL_CTL_ADD, cp->socket, &ev) != 0) {
+    // The socket may be still registered, e.g. after a listener was restarted...
+    if(errno != EEXIST || epoll_ctl(epfd, EPOLL_CTL_MOD, cp->socket, &ev) != 0) status = X_FAILURE;
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if(status == X_NO_INIT) return x_error(X_NO_INIT, ENXIO, fn, "event loop is not running");
+  if(status) return x_error(X_FAILURE, errno, fn, "epoll_ctl(): %s", strerror(errno));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Checks if the calling thread is one of the event loop threads, which must not block on anything
+ * other than servicing the clients.
+ *
+ * \return      TRUE (1) if called from an event loop thread, or else FALSE (0).
+ */
+boolean rIsEventLoopThread(void) {
+  return isLoopThread;
+}
+
+/**
+ * Removes a client from the shared event loop, if it is registered. It should be called before the client's
+ * socket is closed, so the loop will not service a socket descriptor that may be reused by another connection.
+ *
+ * \param cl    Pointer to a Redis client.
+ */
+void rLoopRemoveClientAsync(RedisClient *cl) {
+  const ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  int fd = __atomic_load_n(&epfd, __ATOMIC_ACQUIRE);
+
+  if(fd < 0 || cp->socket < 0) return;
+  if(cp->idx != REDISX_PIPELINE_CHANNEL && cp->idx != REDISX_SUBSCRIPTION_CHANNEL) return;
+
+  // Not necessarily registered, so ENOENT is fine.
+  epoll_ctl(fd, EPOLL_CTL_DEL, cp->socket, NULL);
+}
+
+/// \endcond
+
+/**
+ * Starts the shared event loop, which processes responses on the pipeline and subscription clients of all
+ * Redis instances that were configured to use it via redisxUseEventLoop(), with a fixed number of threads.
+ * It is an alternative to having a dedicated listener thread for every pipeline and subscription client,
+ * which may be preferable when an application connects to many Redis servers (such as all nodes of a large
+ * cluster).
+ *
+ * Note, that while a single client is serviced by only one loop thread at a time, a consumer function that
+ * blocks will hold up that loop thread, delaying the processing of responses for other clients also. The loop
+ * threads also read the remainder of a partially received response in blocking mode, subject to the
+ * socket timeout.
+ *
+ * The event loop is available on Linux only.
+ *
+ * \param threads   Number of loop threads to use (1 or more).
+ * \return          X_SUCCESS (0) if successful, or else X_ALREADY_OPEN if the event loop is already
+ *                  running, X_SIZE_INVALID if the number of threads is not positive, or X_FAILURE if the
+ *                  event loop could not be started (or is not supported on the platform).
+ *
+ * @sa redisxStopEventLoop()
+ * @sa redisxUseEventLoop()
+ */
+int redisxStartEventLoop(int threads) {
+  static const char *fn = "redisxStartEventLoop";
+
+  struct epoll_event ev = {};
+
+  if(threads < 1) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of threads: %d", threads);
+
+  pthread_mutex_lock(&mutex);
+
+  if(isRunning) {
+    pthread_mutex_unlock(&mutex);
+    return x_error(X_ALREADY_OPEN, EALREADY, fn, "event loop is already running");
+  }
+
+  epfd = epoll_create1(EPOLL_CLOEXEC);
+  if(epfd < 0) {
+    pthread_mutex_unlock(&mutex);
+    return x_error(X_FAILURE, errno, fn, "epoll_create1(): %s", strerror(errno));
+  }
+
+  wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  ev.events = EPOLLIN;    // level triggered, so it wakes all threads
+  ev.data.ptr = NULL;
+
+  if(wakefd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev) != 0) {
+    int err = errno;
+    if(wakefd >= 0) close(wakefd);
+    close(epfd);
+    wakefd = epfd = -1;
+    pthread_mutex_unlock(&mutex);
+    return x_error(X_FAILURE, err, fn, "eventfd: %s", strerror(err));
+  }
+
+  loopThreads = (pthread_t *) calloc(threads, sizeof(pthread_t));
+  x_check_alloc(loopThreads);
+
+  isRunning = TRUE;
+
+  for(nThreads = 0; nThreads < threads; nThreads++) {
+    if(pthread_create(&loopThreads[nThreads], NULL, RedisEventLoop, NULL) != 0) {
+      perror("ERROR! Redis-X : pthread_create RedisEventLoop");
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if(nThreads == 0) {
+    redisxStopEventLoop();
+    return x_error(X_FAILURE, errno, fn, "could not start any event loop threads");
+  }
+
+  xvprintf("Redis-X> Started event loop with %d threads.\n", nThreads);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Stops the shared event loop, waiting for the loop threads to finish processing the responses they are
+ * currently handling. Redis instances that use the event loop should be disconnected before stopping it,
+ * since their pipeline and subscription responses will not be processed otherwise.
+ *
+ * \return      X_SUCCESS (0) if successful, or else X_NO_INIT if the event loop was not running.
+ *
+ * @sa redisxStartEventLoop()
+ */
+int redisxStopEventLoop(void) {
+  static const char *fn = "redisxStopEventLoop";
+
+  const uint64_t one = 1;
+  int i;
+
+  pthread_mutex_lock(&mutex);
+
+  if(epfd < 0) {
+    pthread_mutex_unlock(&mutex);
+    return x_error(X_NO_INIT, ENXIO, fn, "event loop is not running");
+  }
+
+  isRunning = FALSE;
+  if(write(wakefd, &one, sizeof(one)) != sizeof(one)) perror("WARNING! Redis-X : event loop wakeup");
+
+  for(i = 0; i < nThreads; i++) pthread_join(loopThreads[i], NULL);
+
+  free(loopThreads);
+  loopThreads = NULL;
+  nThreads = 0;
+
+  close(wakefd);
+  close(epfd);
+  wakefd = epfd = -1;
+
+  pthread_mutex_unlock(&mutex);
+
+  xvprintf("Redis-X> Stopped event loop.\n");
+
+  return X_SUCCESS;
+}
+
+/**
+ * Checks if the shared event loop is currently running.
+ *
+ * \return      TRUE (1) if the event loop is running, or else FALSE (0).
+ *
+ * @sa redisxStartEventLoop()
+ */
+boolean redisxIsEventLoopRunning(void) {
+  return isRunning;
+}
+
+#else
+
+/// \cond PRIVATE
+int rLoopAddClientAsync(RedisClient *cl) {
+  (void) cl;
+  return x_error(X_NO_INIT, ENOSYS, "rLoopAddClientAsync", "event loop is not supported on this platform");
+}
+
+void rLoopRemoveClientAsync(RedisClient *cl) {
+  (void) cl;
+}
+
+boolean rIsEventLoopThread(void) {
+  return FALSE;
+}
+/// \endcond
+
+int redisxStartEventLoop(int threads) {
+  (void) threads;
+  return x_error(X_FAILURE, ENOSYS, "redisxStartEventLoop", "event loop is not supported on this platform");
+}
+
+int redisxStopEventLoop(void) {
+  return x_error(X_NO_INIT, ENOSYS, "redisxStopEventLoop", "event loop is not supported on this platform");
+}
+
+boolean redisxIsEventLoopRunning(void) {
+  return FALSE;
+}
+
+#endif /* __linux__ */
+
+/**
+ * Sets whether the pipeline and subscription clients of a Redis instance should be serviced by the shared event
+ * loop (see redisxStartEventLoop()) instead of dedicated listener threads. The setting applies to listeners
+ * started after the call, i.e. when the pipeline client is (re)connected, or when the first subscription is made.
+ * It is also inherited by the nodes of a cluster that were initialized from this Redis instance. If the event
+ * loop is not running when a listener is started, a dedicated listener thread is used as usual.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \param value     TRUE (non-zero) to use the shared event loop, or FALSE (0) to use dedicated listener threads
+ *                  (default).
+ * \return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                  or X_NO_INIT if the redis instance is not initialized.
+ *
+ * @sa redisxStartEventLoop()
+ */
+int redisxUseEventLoop(Redis *redis, boolean value) {
+  static const char *fn = "redisxUseEventLoop";
+
+  RedisPrivate *p;
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->config.useEventLoop = value ? TRUE : FALSE;
+  rConfigUnlock(redis);
+
+  return X_SUCCESS;
+}
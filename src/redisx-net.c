@@ -45,6 +45,8 @@ extern void rDestroySentinel(RedisSentinel *sentinel);
 static int rStartPipelineListenerAsync(Redis *redis);
 static int rReconnectAsync(Redis *redis, boolean usePipeline);
 static void rDisconnectClientAsync(RedisClient *cl);
+static int rOpenClientAsync(Redis *redis, RedisClient *cl);
+static void rConnectPoolAsync(Redis *redis);
 
 /// \cond PRIVATE
 ///
@@ -330,6 +332,9 @@ int rConnectAsync(Redis *redis, boolean usePipeline) {
     if(rConfirmMasterRoleAsync(redis) != X_SUCCESS) prop_error(fn, rReconnectAsync(redis, usePipeline));
   }
 
+  // Connect additional interactive clients, if any. The primary interactive client can serve requests regardless.
+  rConnectPoolAsync(redis);
+
   if(usePipeline) {
     if(!pp->isEnabled) {
       static int warnedPipeline;
@@ -347,6 +352,10 @@ int rConnectAsync(Redis *redis, boolean usePipeline) {
       warnedPipeline = FALSE;
     }
 
+    // Coalesce pipeline writes, if configured (e.g. for cluster nodes, which inherit the configuration)
+    if(p->config.coalesceSize > 0 && !pp->hasFlusher)
+      rSetCoalescing(redis->pipeline, p->config.coalesceSize, p->config.coalesceMicros);
+
     status = rStartPipelineListenerAsync(redis);
     prop_error(fn, status);
   }
@@ -385,6 +394,9 @@ static void rDisconnectClientAsync(RedisClient *cl) {
   if(sock >= 0) {
     int status;
 
+    // Stop servicing the socket from the event loop, before its descriptor may be reused.
+    rLoopRemoveClientAsync(cl);
+
     cp->socket = -1;                  // Reset the channel's socket descriptor to 'unassigned'
 
     status = close(sock);
@@ -409,9 +421,13 @@ static void rResetClientAsync(RedisClient *cl) {
   cp->pendingRequests = 0;
   pthread_mutex_unlock(&cp->pendingLock);
 
+  // Requests that will not be answered...
+  rCancelRequestsAsync(cp);
+
   cp->isEnabled = FALSE;
   cp->available = 0;
   cp->next = 0;
+  cp->outUsed = 0;
 
 #if(WITH_TLS)
   rDestroyClientTLS(cp);
@@ -462,6 +478,7 @@ void rCloseClient(RedisClient *cl) {
 void rDisconnectAsync(Redis *redis) {
   RedisPrivate *p = (RedisPrivate *) redis->priv;
   Hook *f;
+  int i;
 
   // Disable pipeline listener...
   p->isPipelineListenerEnabled = FALSE;
@@ -475,11 +492,13 @@ void rDisconnectAsync(Redis *redis) {
   rShutdownClientAsync(redis->subscription);
   rShutdownClientAsync(redis->pipeline);
   rShutdownClientAsync(redis->interactive);
+  for(i = 0; i < p->poolSize; i++) rShutdownClientAsync(&p->pool[i]);
 
   // Close clients after obtaining exclusive locks on them...
   rCloseClient(redis->subscription);
   rCloseClient(redis->pipeline);
   rCloseClient(redis->interactive);
+  for(i = 0; i < p->poolSize; i++) rCloseClient(&p->pool[i]);
 
   // Call the cleanup hooks...
   for(f = p->config.firstCleanupCall; f != NULL; f = f->next) f->call(redis);
@@ -588,12 +607,11 @@ static void rUnregisterServer(const Redis *redis) {
 /**
  * Initializes a redis client structure for the specified communication channel
  *
- * @param cl
- * @param idx
+ * @param redis     Pointer to the Redis instance to which the client belongs
+ * @param cl        Pointer to the client to initialize
+ * @param idx       The communication channel of the client
  */
-static void rInitClient(Redis *redis, enum redisx_channel idx) {
-  RedisPrivate *p = (RedisPrivate *) redis->priv;
-  RedisClient *cl = &p->clients[idx];
+static void rInitClient(Redis *redis, RedisClient *cl, enum redisx_channel idx) {
   ClientPrivate *cp;
 
   cp = calloc(1, sizeof(ClientPrivate));
@@ -605,6 +623,9 @@ static void rInitClient(Redis *redis, enum redisx_channel idx) {
   pthread_mutex_init(&cp->readLock, NULL);
   pthread_mutex_init(&cp->writeLock, NULL);
   pthread_mutex_init(&cp->pendingLock, NULL);
+  pthread_cond_init(&cp->outCond, NULL);
+
+  rSetReceiveBufferAsync(cp, REDISX_RCVBUF_SIZE, 0);
 
   cl->priv = cp;
 
@@ -613,6 +634,73 @@ static void rInitClient(Redis *redis, enum redisx_channel idx) {
 
 /// \cond PRIVATE
 
+/**
+ * Sets the size of the receive buffer of a client, and the size up to which it may grow as needed. Any unconsumed
+ * data in the buffer is retained, even if the buffer has to remain larger than requested to accommodate it. The
+ * caller should have an exclusive read lock on the client.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ * \param size      (bytes) The receive buffer size, or &lt;=0 to use the default REDISX_RCVBUF_SIZE.
+ * \param limit     (bytes) The size up to which the buffer may grow, when the data received keeps filling it. Values
+ *                  not exceeding the buffer size disable growth.
+ * \return          X_SUCCESS (0) if successful, or else X_FAILURE if the buffer could not be allocated (the client
+ *                  retains its prior buffer in that case).
+ */
+int rSetReceiveBufferAsync(ClientPrivate *cp, int size, int limit) {
+  int remaining;
+  char *in;
+
+  rUnpinReceiveBufferAsync(cp);
+
+  remaining = cp->available - cp->next;
+  if(size <= 0) size = REDISX_RCVBUF_SIZE;
+  if(remaining < 0) remaining = 0;
+  if(size < remaining) size = remaining;
+
+  cp->inLimit = limit;
+  if(size == cp->inSize) return X_SUCCESS;
+
+  // Move unconsumed data to the front of the buffer...
+  if(remaining > 0 && cp->next > 0) memmove(cp->in, &cp->in[cp->next], remaining);
+  cp->next = 0;
+  cp->available = remaining;
+
+  in = (char *) realloc(cp->in, size);
+  if(!in) return x_error(X_FAILURE, errno, "rSetReceiveBufferAsync", "alloc error (%d bytes)", size);
+
+  cp->in = in;
+  cp->inSize = size;
+
+  return X_SUCCESS;
+}
+
+/**
+ * Leaves a receive buffer that is pinned (see rReadMessageAsync()) to the subscribers that are still using it,
+ * and continues with a new buffer of the same size, holding the unconsumed data. The subscribers' dispatcher
+ * frees the old buffer when it is done with it. It should be called, with the read lock of the client held,
+ * before modifying the contents of the receive buffer.
+ *
+ * \param cp        Pointer to the private data of a Redis client.
+ */
+void rUnpinReceiveBufferAsync(ClientPrivate *cp) {
+  int remaining = cp->available - cp->next;
+  char *in;
+
+  if(!cp->inPinned) return;
+
+  if(remaining < 0) remaining = 0;
+
+  in = (char *) malloc(cp->inSize);
+  x_check_alloc(in);
+
+  if(remaining > 0) memcpy(in, &cp->in[cp->next], remaining);
+
+  cp->in = in;
+  cp->next = 0;
+  cp->available = remaining;
+  cp->inPinned = FALSE;
+}
+
 /**
  * Checks if a client was configured with a low-latency socket connection.
  *
@@ -690,6 +778,24 @@ static int rHelloAsync(RedisClient *cl, const char *clientID) {
  * @sa rConfigLock()
  */
 int rConnectClientAsync(Redis *redis, enum redisx_channel channel) {
+  RedisClient *cl = redisxGetClient(redis, channel);
+  if(!cl) return x_error(REDIS_INVALID_CHANNEL, EINVAL, "rConnectClientAsync", "invalid channel: %d", channel);
+  prop_error("rConnectClientAsync", rOpenClientAsync(redis, cl));
+  return X_SUCCESS;
+}
+
+/**
+ * Connects a Redis client to the Redis server, on the client's own channel. It should be called with the
+ * configuration mutex of the Redis instance locked.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param cl            Pointer to a client of the Redis instance, such as a pooled interactive client.
+ *
+ * \return              X_SUCCESS (0) if successful, or else an error code &lt;0 (see rConnectClientAsync()).
+ *
+ * @sa rConnectClientAsync()
+ */
+static int rOpenClientAsync(Redis *redis, RedisClient *cl) {
   static const char *fn = "rConnectClient";
 
 #if WITH_TLS
@@ -706,9 +812,9 @@ int rConnectClientAsync(Redis *redis, enum redisx_channel channel) {
 
   struct utsname u;
   RedisPrivate *p;
-  RedisClient *cl;
   ClientPrivate *cp;
   RedisConfig *config;
+  enum redisx_channel channel;
 
   const char *channelID;
   char host[200], *id;
@@ -716,11 +822,10 @@ int rConnectClientAsync(Redis *redis, enum redisx_channel channel) {
   uint16_t port;
   int sock;
 
-  cl = redisxGetClient(redis, channel);
-
   p = (RedisPrivate *) redis->priv;
   cp = (ClientPrivate *) cl->priv;
   config = &p->config;
+  channel = cp->idx;
 
   port = p->port > 0 ? p->port : REDISX_TCP_PORT;
 
@@ -782,6 +887,10 @@ int rConnectClientAsync(Redis *redis, enum redisx_channel channel) {
 
   redisxLockClient(cl);
 
+  pthread_mutex_lock(&cp->readLock);
+  rSetReceiveBufferAsync(cp, config->rcvBufSize[channel], config->rcvBufLimit[channel]);
+  pthread_mutex_unlock(&cp->readLock);
+
   cp->socket = sock;
   cp->isEnabled = TRUE;
 
@@ -801,6 +910,20 @@ int rConnectClientAsync(Redis *redis, enum redisx_channel channel) {
 
   free(id);
 
+  // Switch to the selected database. (DB 0 is the default, and the only one that is cluster safe.)
+  if(!status && config->dbIndex > 0) {
+    char idx[20];
+    sprintf(idx, "%d", config->dbIndex);
+    status = redisxSkipReplyAsync(cl);
+    if(!status) status = redisxSendRequestAsync(cl, "SELECT", idx, NULL, NULL);
+  }
+
+  // Cluster replicas serve reads only on connections that enable them.
+  if(!status && p->isReplica && channel != REDISX_SUBSCRIPTION_CHANNEL) {
+    status = redisxSkipReplyAsync(cl);
+    if(!status) status = redisxSendRequestAsync(cl, "READONLY", NULL, NULL, NULL);
+  }
+
   if(status) {
     rCloseClientAsync(cl);
     redisxUnlockClient(cl);
@@ -877,7 +1000,7 @@ Redis *redisxInit(const char *server) {
   x_check_alloc(p->clients);
 
   // Initialize clients.
-  for(i = REDISX_CHANNELS; --i >= 0; ) rInitClient(redis, i);
+  for(i = REDISX_CHANNELS; --i >= 0; ) rInitClient(redis, &p->clients[i], i);
 
   // Alias clients
   redis->interactive = &p->clients[REDISX_INTERACTIVE_CHANNEL];
@@ -889,6 +1012,83 @@ Redis *redisxInit(const char *server) {
   return redis;
 }
 
+/**
+ * Connects the additional interactive clients of a Redis instance, according to the configured pool size. The
+ * pool is allocated on first use. Clients that fail to connect are simply not used until the next reconnection.
+ * It should be called with the configuration mutex of the Redis instance locked.
+ *
+ * \param redis     Pointer to a Redis instance.
+ */
+static void rConnectPoolAsync(Redis *redis) {
+  RedisPrivate *p = (RedisPrivate *) redis->priv;
+  int i;
+
+  if(p->config.poolSize <= 1) return;
+
+  if(!p->pool) {
+    p->pool = (RedisClient *) calloc(p->config.poolSize - 1, sizeof(RedisClient));
+    x_check_alloc(p->pool);
+
+    for(i = 0; i < p->config.poolSize - 1; i++) {
+      rInitClient(redis, &p->pool[i], REDISX_INTERACTIVE_CHANNEL);
+      ((ClientPrivate *) p->pool[i].priv)->timeoutMillis = ((ClientPrivate *) redis->interactive->priv)->timeoutMillis;
+    }
+
+    p->poolSize = p->config.poolSize - 1;
+  }
+
+  xvprintf("Redis-X> Connect %d pooled interactive clients.\n", p->poolSize);
+
+  for(i = 0; i < p->poolSize; i++) {
+    const ClientPrivate *cp = (ClientPrivate *) p->pool[i].priv;
+    if(cp->isEnabled) continue;
+    if(rOpenClientAsync(redis, &p->pool[i]) != X_SUCCESS)
+      x_warn("RedisX", "pooled interactive client %d connection failed.\n", i + 1);
+  }
+}
+
+/**
+ * Frees up the resources used by a client.
+ *
+ * \param cl    Pointer to a Redis client.
+ */
+static void rDestroyClient(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  if(!cp) return;
+
+  // Stop the flusher thread, if any.
+  rSetCoalescing(cl, 0, 0);
+
+  redisxDestroyRESP(cp->attributes);
+  if(cp->in) free(cp->in);
+  if(cp->out) free(cp->out);
+  pthread_mutex_destroy(&cp->readLock);
+  pthread_mutex_destroy(&cp->writeLock);
+  pthread_mutex_destroy(&cp->pendingLock);
+  pthread_cond_destroy(&cp->outCond);
+
+  free(cp);
+  cl->priv = NULL;
+}
+
+/**
+ * Frees up the additional interactive clients of a Redis instance, if any. The pooled clients should be
+ * disconnected before calling this.
+ *
+ * \param p     Pointer to the private data of a Redis instance.
+ */
+static void rDestroyPool(RedisPrivate *p) {
+  int i;
+
+  if(!p->pool) return;
+
+  for(i = p->poolSize; --i >= 0; ) rDestroyClient(&p->pool[i]);
+  free(p->pool);
+
+  p->pool = NULL;
+  p->poolSize = 0;
+}
+
 /**
  * Destroys a Redis intance, disconnecting any clients that may be connected, and freeing all resources
  * used by that Redis instance.
@@ -906,20 +1106,11 @@ void redisxDestroy(Redis *redis) {
 
   if(redisxIsConnected(redis)) redisxDisconnect(redis);
 
-  for(i = REDISX_CHANNELS; --i >= 0; ) {
-    ClientPrivate *cp = (ClientPrivate *) p->clients[i].priv;
-    if(!cp) continue;
-
-    redisxDestroyRESP(cp->attributes);
-    pthread_mutex_destroy(&cp->readLock);
-    pthread_mutex_destroy(&cp->writeLock);
-    pthread_mutex_destroy(&cp->pendingLock);
-
-    free(cp);
-  }
-
+  for(i = REDISX_CHANNELS; --i >= 0; ) rDestroyClient(&p->clients[i]);
+  rDestroyPool(p);
 
   redisxDestroyRESP(p->helloData);
+  rDestroySubscriberPool(p);
   redisxClearSubscribers(redis);
   rDestroySentinel(p->sentinel);
   rClearConfig(&p->config);
@@ -955,6 +1146,226 @@ int redisxSetTcpBuf(Redis *redis, int size) {
   return X_SUCCESS;
 }
 
+/**
+ * Sets the number of interactive connections to use for a Redis instance. With more than one connection, blocking
+ * requests, such as redisxRequest(), redisxArrayRequest(), redisxGetValue(), or redisxGetTable(), from different
+ * threads are spread over the connections, instead of waiting for each other's round trips to complete on a single
+ * connection. Each request uses a connection that is not busy, if there is one. The setting is also applied to the
+ * nodes of a cluster, which were initialized from this Redis instance.
+ *
+ * The primary interactive client (`redis->interactive`) is always part of the pool. It is the one that is used
+ * for all connection-level operations, and by the functions that take an explicit client argument.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \param n         Number of interactive connections to use. Values &lt;=1 use a single interactive connection
+ *                  (default).
+ * \return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL, X_NO_INIT if the
+ *                  redis instance is not initialized, or X_ALREADY_OPEN if the Redis instance is currently
+ *                  connected.
+ *
+ * @sa redisxGetInteractivePoolSize()
+ * @sa redisxGetLockedConnectedClient()
+ */
+int redisxSetInteractivePoolSize(Redis *redis, int n) {
+  static const char *fn = "redisxSetInteractivePoolSize";
+
+  RedisPrivate *p;
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+
+  if(redisxIsConnected(redis)) {
+    rConfigUnlock(redis);
+    return x_error(X_ALREADY_OPEN, EISCONN, fn, "cannot change pool size while connected");
+  }
+
+  if(n < 1) n = 1;
+  p->config.poolSize = n;
+
+  // Re-allocate the pool at the next connection, if size changed.
+  if(p->pool && p->poolSize != n - 1) rDestroyPool(p);
+
+  rConfigUnlock(redis);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the number of interactive connections configured for a Redis instance.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \return          The number of interactive connections (1 or more), or else an error code &lt;0, such as
+ *                  X_NULL if the redis instance is NULL, or X_NO_INIT if the redis instance is not initialized.
+ *
+ * @sa redisxSetInteractivePoolSize()
+ */
+int redisxGetInteractivePoolSize(Redis *redis) {
+  static const char *fn = "redisxGetInteractivePoolSize";
+
+  const RedisPrivate *p;
+  int n;
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  n = p->config.poolSize > 1 ? p->config.poolSize : 1;
+  rConfigUnlock(redis);
+
+  return n;
+}
+
+/**
+ * Enables or disables write coalescing on the pipeline client of a Redis instance. With coalescing, pipelined requests
+ * are not sent one by one, but rather they are accumulated in a buffer, which is sent when it cannot take more data,
+ * when the oldest request in it has been waiting for the specified delay, or when redisxFlushAsync() is called. This
+ * way many requests may be sent in a single TCP segment, when many requests are submitted in quick succession, e.g.
+ * from many threads. The setting takes effect immediately, and is also applied to the nodes of a cluster, which were
+ * initialized from this Redis instance.
+ *
+ * A background thread takes care of sending requests that have waited for the specified delay. It does not
+ * consume any CPU while the buffer is empty.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param size          (bytes) Size of the coalescing buffer, or &lt;=0 to disable coalescing (default).
+ * \param delayMicros   [us] Maximum time requests may wait in the buffer, or &lt;=0 to use the default
+ *                      (REDISX_COALESCE_DELAY_MICROS).
+ * \return              X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                      X_NO_INIT if the redis instance is not initialized, or X_FAILURE if the buffer could not
+ *                      be allocated, or the background thread could not be started.
+ *
+ * @sa redisxFlushAsync()
+ */
+int redisxSetPipelineCoalescing(Redis *redis, int size, int delayMicros) {
+  static const char *fn = "redisxSetPipelineCoalescing";
+
+  RedisPrivate *p;
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->config.coalesceSize = size;
+  p->config.coalesceMicros = delayMicros;
+  rConfigUnlock(redis);
+
+  prop_error(fn, rSetCoalescing(redis->pipeline, size, delayMicros));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sets the size of the receive buffer for the specified client channel. The receive buffer holds data from the socket
+ * until it is consumed. A larger buffer means fewer calls to read from the socket when receiving large responses, such
+ * as to `HGETALL` or `MGET` with many elements, or when pipelining many requests. The setting takes effect
+ * immediately for the client, and is also applied to future connections, including to the nodes of a cluster, which
+ * were initialized from this Redis instance. If the client is in the middle of a read, the call will wait for the
+ * read to complete.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param channel   REDISX_INTERACTIVE_CHANNEL, REDISX_PIPELINE_CHANNEL, or REDISX_SUBSCRIPTION_CHANNEL
+ * @param size      (bytes) requested buffer size, or &lt;=0 to use the default (REDISX_RCVBUF_SIZE).
+ * @return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                  or X_NO_INIT if the redis instance is not initialized, REDIS_INVALID_CHANNEL if the
+ *                  channel is invalid, or X_FAILURE if the buffer could not be allocated.
+ *
+ * @sa redisxSetReceiveBufferLimit()
+ * @sa redisxGetReceiveBufferSize()
+ * @sa redisxSetTcpBuf()
+ */
+int redisxSetReceiveBufferSize(Redis *redis, enum redisx_channel channel, int size) {
+  static const char *fn = "redisxSetReceiveBufferSize";
+
+  RedisPrivate *p;
+  ClientPrivate *cp;
+  int limit, status;
+
+  if(channel < 0 || channel >= REDISX_CHANNELS) return x_error(REDIS_INVALID_CHANNEL, EINVAL, fn, "channel %d is out of range", channel);
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->config.rcvBufSize[channel] = size;
+  limit = p->config.rcvBufLimit[channel];
+  rConfigUnlock(redis);
+
+  cp = (ClientPrivate *) p->clients[channel].priv;
+
+  pthread_mutex_lock(&cp->readLock);
+  status = rSetReceiveBufferAsync(cp, size, limit);
+  pthread_mutex_unlock(&cp->readLock);
+
+  prop_error(fn, status);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Allows the receive buffer of the specified client channel to grow automatically, up to the specified size, as
+ * needed. The buffer is grown (doubled in size) every time the data received from the socket fills it entirely,
+ * which is a sign that larger reads would be more efficient. As such, it is a good choice for clients that may
+ * receive a mix of small and large responses, such as the pipeline client. Like redisxSetReceiveBufferSize(), it
+ * applies to the current client as well as future connections.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param channel   REDISX_INTERACTIVE_CHANNEL, REDISX_PIPELINE_CHANNEL, or REDISX_SUBSCRIPTION_CHANNEL
+ * @param limit     (bytes) the size up to which the receive buffer may grow, or &lt;=0 to disable growth.
+ * @return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                  or X_NO_INIT if the redis instance is not initialized, or REDIS_INVALID_CHANNEL if the
+ *                  channel is invalid.
+ *
+ * @sa redisxSetReceiveBufferSize()
+ * @sa redisxGetReceiveBufferSize()
+ */
+int redisxSetReceiveBufferLimit(Redis *redis, enum redisx_channel channel, int limit) {
+  static const char *fn = "redisxSetReceiveBufferLimit";
+
+  RedisPrivate *p;
+  ClientPrivate *cp;
+
+  if(channel < 0 || channel >= REDISX_CHANNELS) return x_error(REDIS_INVALID_CHANNEL, EINVAL, fn, "channel %d is out of range", channel);
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->config.rcvBufLimit[channel] = limit;
+  rConfigUnlock(redis);
+
+  cp = (ClientPrivate *) p->clients[channel].priv;
+
+  pthread_mutex_lock(&cp->readLock);
+  cp->inLimit = limit;
+  pthread_mutex_unlock(&cp->readLock);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the current size of the receive buffer for the specified client channel.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param channel   REDISX_INTERACTIVE_CHANNEL, REDISX_PIPELINE_CHANNEL, or REDISX_SUBSCRIPTION_CHANNEL
+ * @return          (bytes) The current receive buffer size, or else an error code &lt;0, e.g. X_NULL if the
+ *                  redis instance is NULL, or X_NO_INIT if the redis instance is not initialized, or
+ *                  REDIS_INVALID_CHANNEL if the channel is invalid.
+ *
+ * @sa redisxSetReceiveBufferSize()
+ * @sa redisxSetReceiveBufferLimit()
+ */
+int redisxGetReceiveBufferSize(Redis *redis, enum redisx_channel channel) {
+  static const char *fn = "redisxGetReceiveBufferSize";
+
+  const RedisPrivate *p;
+  ClientPrivate *cp;
+  int size;
+
+  if(channel < 0 || channel >= REDISX_CHANNELS) return x_error(REDIS_INVALID_CHANNEL, EINVAL, fn, "channel %d is out of range", channel);
+  prop_error(fn, redisxCheckValid(redis));
+
+  p = (const RedisPrivate *) redis->priv;
+  cp = (ClientPrivate *) p->clients[channel].priv;
+
+  pthread_mutex_lock(&cp->readLock);
+  size = cp->inSize;
+  pthread_mutex_unlock(&cp->readLock);
+
+  return size;
+}
+
 /**
  * Changes the host name for the Redis server, prior to calling `redisxConnect()`.
  *
@@ -1105,6 +1516,40 @@ boolean redisxIsConnected(Redis *redis) {
   return ip->isEnabled;
 }
 
+/// \cond PRIVATE
+
+/**
+ * Processes a response received on the pipeline client, passing it to the callback of the request it
+ * answers, if the request was sent via redisxSendRequestCb(), or else to the user-defined pipeline
+ * consumer function, if any. Confirmations (simple strings) are not passed to the pipeline consumer.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param reply         The response received on the pipeline client. It remains owned by the caller.
+ */
+void rProcessPipelineReply(Redis *redis, RESP *reply) {
+  static long lastError;
+
+  const RedisPrivate *p = (RedisPrivate *) redis->priv;
+  void (*consume)(RESP *response);
+
+  // Replies to requests with a dedicated callback
+  if(rCompleteRequestAsync(redis->pipeline, reply)) return;
+
+  if(reply->n < 0) {
+    if(reply->n != lastError) fprintf(stderr, "ERROR! Redis-X: pipeline parse error: %d.\n", reply->n);
+    lastError = reply->n;
+    return;
+  }
+
+  // Skip confirms...
+  if(reply->type == RESP_SIMPLE_STRING) return;
+
+  consume = p->config.pipelineConsumerFunc;
+  if(consume) consume(reply);
+}
+
+/// \endcond
+
 /**
  * The listener function that processes pipelined responses in the background. It is started when Redis
  * is connected with the pipeline enabled.
@@ -1115,14 +1560,13 @@ boolean redisxIsConnected(Redis *redis) {
  *
  */
 void *RedisPipelineListener(void *pRedis) {
-  static long counter, lastError;
+  static long counter;
 
   Redis *redis = (Redis *) pRedis;
   RedisPrivate *p;
   RedisClient *cl;
   ClientPrivate *cp;
   RESP *reply = NULL;
-  void (*consume)(RESP *response);
 
   pthread_detach(pthread_self());
 
@@ -1144,17 +1588,7 @@ void *RedisPipelineListener(void *pRedis) {
 
     counter++;
 
-    if(reply->n < 0) {
-      if(reply->n != lastError) fprintf(stderr, "ERROR! Redis-X: pipeline parse error: %d.\n", reply->n);
-      lastError = reply->n;
-      continue;
-    }
-
-    // Skip confirms...
-    if(reply->type == RESP_SIMPLE_STRING) continue;
-
-    consume = p->config.pipelineConsumerFunc;
-    if(consume) consume(reply);
+    rProcessPipelineReply(redis, reply);
 
 #if REDISX_LISTENER_YIELD_COUNT > 0
     // Allow the waiting processes to take control...
@@ -1197,6 +1631,10 @@ static int rStartPipelineListenerAsync(Redis *redis) {
 
   p->isPipelineListenerEnabled = TRUE;
 
+  // Use the shared event loop, if configured and running...
+  if(p->config.useEventLoop && redisxIsEventLoopRunning())
+    if(rLoopAddClientAsync(redis->pipeline) == X_SUCCESS) return 0;
+
   if (pthread_create(&p->pipelineListenerTID, NULL, RedisPipelineListener, redis) == -1) {
     perror("ERROR! Redis-X : pthread_create PipelineListener");
     p->isPipelineListenerEnabled = FALSE;
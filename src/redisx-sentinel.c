@@ -350,6 +350,136 @@ int redisxSetSentinelTimeout(Redis *redis, int millis) {
   return status;
 }
 
+/**
+ * Returns a field value from the description of a replica in the response to `SENTINEL replicas`.
+ *
+ * @param desc    Description of a replica (as a RESP2 array of field / value pairs, or a RESP3 map).
+ * @param name    The name of the field
+ * @return        The string value of the field, or NULL if not found.
+ */
+static const char *rGetReplicaField(const RESP *desc, const char *name) {
+  if(!desc) return NULL;
+
+  if(desc->type == RESP3_MAP) {
+    const RedisMap *e = redisxGetKeywordEntry(desc, name);
+    return (e && e->value) ? (char *) e->value->value : NULL;
+  }
+
+  if(desc->type == RESP_ARRAY) {
+    const RESP **component = (const RESP **) desc->value;
+    int i;
+
+    for(i = 0; i + 1 < desc->n; i += 2) if(component[i] && component[i]->value && strcmp((char *) component[i]->value, name) == 0)
+      return component[i + 1] ? (char *) component[i + 1]->value : NULL;
+  }
+
+  return NULL;
+}
+
+/**
+ * Initializes a Redis instance for one of the replicas of a Sentinel master, e.g. to spread read-only
+ * queries over replicas. The replicas are obtained via `SENTINEL replicas` from the first Sentinel server
+ * that responds, and only replicas that are not flagged as down or disconnected are considered. Successive
+ * calls return the healthy replicas in rotation. The returned instance inherits the configuration of the
+ * Sentinel master (e.g. authentication, socket and protocol settings, and hooks), but it is not
+ * connected. Note, that replicas may lag behind the master, so reads from replicas may return slightly
+ * stale data.
+ *
+ * @param redis     The Redis instance, which was initialized for Sentinel via redisxInitSentinel().
+ * @return          A new, unconnected Redis instance for a replica, or NULL if the instance was not
+ *                  initialized for Sentinel (errno = EINVAL), or if no healthy replica was found
+ *                  (errno = ENXIO).
+ *
+ * @sa redisxInitSentinel()
+ * @sa redisxClusterSetReadPreference()
+ */
+Redis *redisxInitSentinelReplica(Redis *redis) {
+  static const char *fn = "redisxInitSentinelReplica";
+  static unsigned int next;
+
+  const RedisPrivate *p;
+  const RedisSentinel *s;
+  Redis *replica = NULL;
+  RESP *reply = NULL;
+  int i, n = 0;
+
+  if(rConfigLock(redis) != X_SUCCESS) return x_trace_null(fn, NULL);
+
+  p = (RedisPrivate *) redis->priv;
+  s = p->sentinel;
+  if(!s) {
+    rConfigUnlock(redis);
+    x_error(0, EINVAL, fn, "Redis was not initialized for Sentinel");
+    return NULL;
+  }
+
+  // Query the replicas from the first Sentinel that responds.
+  for(i = 0; i < s->nServers && !reply; i++) {
+    Redis *node = redisxInit(s->servers[i].host);
+    int status;
+
+    if(!node) continue;
+
+    redisxSetPort(node, s->servers[i].port);
+    redisxSetSocketTimeout(node, s->timeoutMillis);
+
+    if(redisxConnect(node, FALSE) == X_SUCCESS) {
+      reply = redisxRequest(node, "SENTINEL", "replicas", s->serviceName, NULL, &status);
+      if(redisxCheckRESP(reply, RESP_ARRAY, 0) != X_SUCCESS) {
+        redisxDestroyRESP(reply);
+        reply = NULL;
+      }
+      redisxDisconnect(node);
+    }
+
+    redisxDestroy(node);
+  }
+
+  if(reply) {
+    const RESP **desc = (const RESP **) reply->value;
+    int k;
+
+    // Count the healthy replicas
+    for(k = 0; k < reply->n; k++) {
+      const char *flags = rGetReplicaField(desc[k], "flags");
+      if(flags && (strstr(flags, "down") || strstr(flags, "disconnected"))) continue;
+      n++;
+    }
+
+    // Pick the next healthy one in rotation
+    if(n > 0) {
+      int pick = (int) (__atomic_fetch_add(&next, 1, __ATOMIC_RELAXED) % n);
+
+      for(k = 0; k < reply->n; k++) {
+        const char *flags = rGetReplicaField(desc[k], "flags");
+        const char *ip, *port;
+
+        if(flags && (strstr(flags, "down") || strstr(flags, "disconnected"))) continue;
+        if(pick-- > 0) continue;
+
+        ip = rGetReplicaField(desc[k], "ip");
+        port = rGetReplicaField(desc[k], "port");
+        if(!ip || !port) break;
+
+        replica = redisxInit(ip);
+        if(replica) {
+          redisxSetPort(replica, (int) strtol(port, NULL, 10));
+          rCopyConfig(&p->config, replica);
+        }
+        break;
+      }
+    }
+
+    redisxDestroyRESP(reply);
+  }
+
+  rConfigUnlock(redis);
+
+  if(!replica) x_error(0, ENXIO, fn, "no healthy replica found for %s", s->serviceName);
+
+  return replica;
+}
+
 /// \cond PRIVATE
 void rDestroySentinel(RedisSentinel *sentinel) {
   if(!sentinel) return;
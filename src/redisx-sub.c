@@ -12,11 +12,71 @@
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
+#include <limits.h>
 
 #include "redisx-priv.h"
 
 static int rStartSubscriptionListenerAsync(Redis *redis);
 
+/// \cond PRIVATE
+
+/**
+ * A node in the prefix trie that indexes subscribers by their channel stems. Each node represents
+ * a channel prefix, and lists the subscribers whose stem is that prefix. Once published, a trie is
+ * never modified. Instead, it is replaced by a new one whenever the subscribers change.
+ */
+typedef struct SubscriberTrie {
+  RedisSubscriberCall *calls;     ///< Subscribers whose channel stem ends at this node
+  int n_calls;                    ///< Number of subscribers at this node
+  char *keys;                     ///< The next channel character for each of the child nodes
+  struct SubscriberTrie **next;   ///< Child nodes
+  int n_next;                     ///< Number of child nodes
+  struct SubscriberTrie *retired; ///< (root only) The next retired index waiting to be freed
+} SubscriberTrie;
+
+/**
+ * A PUB/SUB message waiting to be dispatched to subscribers. It is allocated together with the
+ * strings it references.
+ */
+typedef struct {
+  char *pattern;                  ///< The subscription pattern that matched, or NULL
+  char *channel;                  ///< The channel the message was published on
+  char *msg;                      ///< The message payload, or NULL
+  int length;                     ///< [bytes] Length of the message payload.
+} SubscriberMessage;
+
+struct SubscriberPool;
+
+/**
+ * A thread dispatching PUB/SUB messages to subscribers, with its own bounded queue of messages.
+ */
+typedef struct {
+  struct SubscriberPool *pool;    ///< The pool this worker belongs to
+  pthread_t tid;                  ///< The worker thread
+  pthread_mutex_t mutex;          ///< mutex for accessing the queue
+  pthread_cond_t notEmpty;        ///< Signaled when a message is added to the queue
+  pthread_cond_t notFull;         ///< Signaled when a message is taken from the queue
+  SubscriberMessage **queue;      ///< Ring buffer of waiting messages
+  int size;                       ///< Capacity of the queue
+  int head;                       ///< Index of the oldest message in the queue
+  int count;                      ///< Number of messages in the queue
+  boolean stop;                   ///< Tells the worker to stop, once the queue is drained
+} SubscriberWorker;
+
+/**
+ * A pool of threads dispatching PUB/SUB messages to subscribers. Messages are assigned to workers by
+ * the hash of their channel, so messages on the same channel are delivered in order.
+ */
+typedef struct SubscriberPool {
+  Redis *redis;                   ///< The Redis instance, whose subscribers are called
+  SubscriberWorker *workers;      ///< Array of workers
+  int n;                          ///< Number of workers
+  boolean drop;                   ///< Whether to drop messages if a queue is full, rather than wait.
+  long dropped;                   ///< Number of messages dropped so far
+} SubscriberPool;
+
+/// \endcond
+
 /**
  * Waits to get exlusive access to Redis scubscriber calls.
  *
@@ -45,6 +105,98 @@ static int rSubscriberUnlock(Redis *redis) {
   return X_SUCCESS;
 }
 
+/**
+ * Frees a subscriber trie, including all of its child nodes.
+ *
+ * @param t     The subscriber trie (it may be NULL).
+ */
+static void rDestroySubscriberTrie(SubscriberTrie *t) {
+  int i;
+
+  if(!t) return;
+
+  for(i = 0; i < t->n_next; i++) rDestroySubscriberTrie(t->next[i]);
+
+  if(t->calls) free(t->calls);
+  if(t->keys) free(t->keys);
+  if(t->next) free(t->next);
+  free(t);
+}
+
+/**
+ * Adds a subscriber to a subscriber trie, which is still being built.
+ *
+ * @param root    The root node of the trie
+ * @param stem    The channel stem of the subscriber, or NULL to receive messages on all channels.
+ * @param f       The subscriber function
+ */
+static void rAddToSubscriberTrie(SubscriberTrie *root, const char *stem, RedisSubscriberCall f) {
+  SubscriberTrie *t = root;
+
+  if(stem) for(; *stem; stem++) {
+    const char *k = t->n_next ? (const char *) memchr(t->keys, *stem, t->n_next) : NULL;
+
+    if(k) {
+      t = t->next[k - t->keys];
+      continue;
+    }
+
+    t->keys = (char *) realloc(t->keys, t->n_next + 1);
+    x_check_alloc(t->keys);
+
+    t->next = (SubscriberTrie **) realloc(t->next, (t->n_next + 1) * sizeof(SubscriberTrie *));
+    x_check_alloc(t->next);
+
+    t->keys[t->n_next] = *stem;
+    t->next[t->n_next] = (SubscriberTrie *) calloc(1, sizeof(SubscriberTrie));
+    x_check_alloc(t->next[t->n_next]);
+
+    t = t->next[t->n_next++];
+  }
+
+  t->calls = (RedisSubscriberCall *) realloc(t->calls, (t->n_calls + 1) * sizeof(RedisSubscriberCall));
+  x_check_alloc(t->calls);
+
+  t->calls[t->n_calls++] = f;
+}
+
+/**
+ * Rebuilds the subscriber index after the subscriber list was modified, and publishes it for
+ * lock-free use by message dispatch. The prior index is retired, and freed once no dispatch may be
+ * using it anymore. Dispatching threads are never waited on, so subscribers may be added or removed
+ * from within subscriber callbacks also. The caller must have an exclusive lock on the subscriber
+ * list.
+ *
+ * @param p     The private data of a Redis instance.
+ */
+static void rUpdateSubscriberIndexAsync(RedisPrivate *p) {
+  SubscriberTrie *t = NULL, *old;
+  const MessageConsumer *c;
+
+  if(p->subscriberList) {
+    t = (SubscriberTrie *) calloc(1, sizeof(SubscriberTrie));
+    x_check_alloc(t);
+    for(c = p->subscriberList; c != NULL; c = c->next) rAddToSubscriberTrie(t, c->channelStem, c->func);
+  }
+
+  old = __atomic_exchange_n(&p->subscriberIndex, t, __ATOMIC_SEQ_CST);
+
+  if(old) {
+    old->retired = p->retiredIndex;
+    p->retiredIndex = old;
+  }
+
+  // Dispatches that started after the exchange can only use the new index. So, if no dispatch is
+  // in progress now, none can be using the retired ones.
+  if(__atomic_load_n(&p->subscriberReaders, __ATOMIC_SEQ_CST) == 0) {
+    while(p->retiredIndex) {
+      old = p->retiredIndex;
+      p->retiredIndex = old->retired;
+      rDestroySubscriberTrie(old);
+    }
+  }
+}
+
 /**
  * Connects the subscription client/channel to the Redis server, for sending and receiving
  * PUB/SUB commands and messages, and starts the SubscriptionListener thread for
@@ -165,6 +317,89 @@ int redisxPublish(Redis *redis, const char *channel, const char *data, int lengt
   return X_SUCCESS;
 }
 
+/**
+ * Sends a Redis PUB/SUB message asynchronously, whose content is assembled from several memory segments (e.g. a
+ * header and a large data array). The segments are sent from where they are, as a single binary-safe message,
+ * without concatenating them first. The caller should have an exclusive lock on the interactive Redis channel
+ * before calling this.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param channel       Redis PUB/SUB channel on which to notify
+ * \param parts         The memory segments that make up the message, in order.
+ * \param n             The number of memory segments.
+ *
+ * \return      X_SUCCESS (0) if successful, or else
+ *              X_NULL          if the redis instance or the parts are NULL
+ *              X_NAME_INVALID  if the PUB/SUB channel is null or empty
+ *              X_SIZE_INVALID  if the number of parts is negative, or the message exceeds INT_MAX bytes
+ *              or an error code (&lt;0) returned by redisxSendArrayRequestAsync().
+ *
+ * @sa redisxPublishV()
+ * @sa redisxPublishAsync()
+ */
+int redisxPublishVAsync(Redis *redis, const char *channel, const struct iovec *parts, int n) {
+  static const char *fn = "redisxPublishVAsync";
+
+  const char *args[2];
+  long long total = 0;
+  int i;
+
+  prop_error(fn, redisxCheckValid(redis));
+
+  if(channel == NULL) return x_error(X_NULL, EINVAL, fn, "channel parameter is NULL");
+  if(*channel == '\0') return x_error(X_NAME_INVALID, EINVAL, fn, "channel parameter is empty");
+  if(n < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid number of parts: %d", n);
+  if(parts == NULL && n > 0) return x_error(X_NULL, EINVAL, fn, "parts parameter is NULL");
+
+  // Validate the message size before sending anything, including the CLIENT REPLY SKIP
+  for(i = 0; i < n; i++) total += parts[i].iov_len;
+  if(total > INT_MAX) return x_error(X_SIZE_INVALID, EINVAL, fn, "message too large: %lld bytes", total);
+
+  args[0] = "PUBLISH";
+  args[1] = channel;
+
+  prop_error(fn, redisxSkipReplyAsync(redis->interactive));
+  prop_error(fn, rSendScatterRequestAsync(redis->interactive, args, 2, parts, n));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sends a Redis PUB/SUB message on the specified channel, whose content is assembled from several memory segments
+ * (e.g. a header and a large data array). The segments are sent from where they are, as a single binary-safe
+ * message, without concatenating them first. Redis must be connected before attempting to send messages.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param channel       Redis PUB/SUB channel on which to notify
+ * \param parts         The memory segments that make up the message, in order.
+ * \param n             The number of memory segments.
+ *
+ * \return      X_SUCCESS       if the message was successfullt sent.
+ *              X_NO_INIT       if the Redis library was not initialized via initRedis().
+ *              X_NO_SERVICE    if there was a connection problem.
+ *
+ * @sa redisxPublishVAsync()
+ * @sa redisxPublish()
+ */
+int redisxPublishV(Redis *redis, const char *channel, const struct iovec *parts, int n) {
+  static const char *fn = "redisxPublishV";
+
+  int status;
+
+  prop_error(fn, redisxCheckValid(redis));
+  prop_error(fn, redisxLockConnected(redis->interactive));
+
+  status = redisxPublishVAsync(redis, channel, parts, n);
+
+  redisxUnlockClient(redis->interactive);
+
+  prop_error(fn, status);
+
+  xvprintf("Redis-X> sent %d-part message to %s, channel %s.\n", n, redis->id, channel);
+
+  return X_SUCCESS;
+}
+
 /**
  * Sends a regular string terminated Redis PUB/SUB message on the specified channel.
  * Same as redisxPublish() with the length argument set to the length of the
@@ -191,27 +426,22 @@ int redisxNotify(Redis *redis, const char *channel, const char *message) {
   return X_SUCCESS;
 }
 
+/// \cond PRIVATE
+
 /**
- * Add a targeted subscriber processing function to the list of functions that process
- * Redis PUB/SUB responses. You will still have to subscribe the relevant PUB/SUB messages
- * from redis separately, using redisxSubscribe() before any messages are delivered to
- * this client. If the subscriber with the same callback function and channel stem
- * is already added, this call simply return and will NOT create a duplicate enry.
- * However, the same callback may be added multiple times with different channel stems
- * (which pre-filter what messages each of the callbacks may get).
+ * Adds a subscriber callback on behalf of an owner, such as a cluster, which can later remove its own
+ * subscribers, without affecting the ones added by others (or the user) with the same callback function.
  *
  * \param redis         Pointer to a Redis instance.
- * \param channelStem   If NULL, the consumer will receive all Redis messages published to the given channel.
- *                      Otherwise, the consumer will be notified only if the incoming channel begins with the
- *                      specified stem.
+ * \param channelStem   Channel stem, or NULL to receive all messages.
  * \param f             A function that consumes subscription messages.
+ * \param owner         The owner of the subscriber, or NULL for subscribers added by the user.
+ * \return              X_SUCCESS (0) if successful, or else an error code &lt;0.
  *
- * @sa redisxRemoveSubscribers()
- * @sa redisxSubscribe()
- *
+ * @sa rRemoveSubscribers()
  */
-int redisxAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCall f) {
-  static const char *fn = "redisxAddSubscriber";
+int rAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCall f, const void *owner) {
+  static const char *fn = "rAddSubscriber";
 
   MessageConsumer *c;
   RedisPrivate *p;
@@ -221,17 +451,17 @@ int redisxAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCa
 
   // Check if the subscriber is already listed with the same stem. If so, nothing to do...
   for(c = p->subscriberList; c != NULL; c = c->next) {
-    if(f != c->func) continue;
+    if(f != c->func || owner != c->owner) continue;
 
     if(channelStem) {
-      if(strcmp(channelStem, c->channelStem)) continue;
+      if(!c->channelStem || strcmp(channelStem, c->channelStem)) continue;
     }
     else if(c->channelStem) continue;
 
     // This subscriber is already listed. Nothing to do.
     rSubscriberUnlock(redis);
 
-    x_warn(fn, "Matching subscriber callback for stem %s already listed. Nothing to do.\n", channelStem);
+    x_warn(fn, "Matching subscriber callback for stem %s already listed. Nothing to do.\n", channelStem ? channelStem : "<all>");
     return X_SUCCESS;
   }
 
@@ -239,35 +469,59 @@ int redisxAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCa
   x_check_alloc(c);
 
   c->func = f;
+  c->owner = owner;
   c->channelStem = xStringCopyOf(channelStem);
   c->next = p->subscriberList;
   p->subscriberList = c;
 
+  rUpdateSubscriberIndexAsync(p);
+
   rSubscriberUnlock(redis);
 
-  xvprintf("Redis-X> Added new subscriber callback for stem %s.\n", channelStem);
+  xvprintf("Redis-X> Added new subscriber callback for stem %s.\n", channelStem ? channelStem : "<all>");
   return X_SUCCESS;
 }
 
+/// \endcond
+
 /**
- * Removes all instances of a subscribe consumer function from the current list of consumers.
- * This calls only deactivates the specified processing callback function(s), without
- * stopping the delivery of associated messages. To stop Redis sending messages that are
- * no longer being processed, you should also call redisxUnsubscribe() as appropriate.
+ * Add a targeted subscriber processing function to the list of functions that process
+ * Redis PUB/SUB responses. You will still have to subscribe the relevant PUB/SUB messages
+ * from redis separately, using redisxSubscribe() before any messages are delivered to
+ * this client. If the subscriber with the same callback function and channel stem
+ * is already added, this call simply return and will NOT create a duplicate enry.
+ * However, the same callback may be added multiple times with different channel stems
+ * (which pre-filter what messages each of the callbacks may get).
  *
- * \param redis     Pointer to a Redis instance.
- * \param f         The consumer function to remove from the list of active subscribers.
+ * \param redis         Pointer to a Redis instance.
+ * \param channelStem   If NULL, the consumer will receive all Redis messages published to the given channel.
+ *                      Otherwise, the consumer will be notified only if the incoming channel begins with the
+ *                      specified stem.
+ * \param f             A function that consumes subscription messages.
  *
- * \return  The number of instances of f() that have been removed from the list of subscribers.
+ * @sa redisxRemoveSubscribers()
+ * @sa redisxSubscribe()
  *
- * \sa redisxAddSubscriber()
- * @sa redisxClearSubscribers()
- * @sa redisxUnsubscrive()
  */
-// cppcheck-suppress constParameter
-// cppcheck-suppress constParameterPointer
-int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f) {
-  static const char *fn = "redisxRemoveSubscribers";
+int redisxAddSubscriber(Redis *redis, const char *channelStem, RedisSubscriberCall f) {
+  prop_error("redisxAddSubscriber", rAddSubscriber(redis, channelStem, f, NULL));
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Removes all instances of a subscriber callback that were added by the specified owner.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \param f         The consumer function to remove.
+ * \param owner     The owner of the subscribers, or NULL for subscribers added by the user.
+ * \return          The number of subscribers removed, or else an error code &lt;0.
+ *
+ * @sa rAddSubscriber()
+ */
+int rRemoveSubscribers(Redis *redis, RedisSubscriberCall f, const void *owner) {
+  static const char *fn = "rRemoveSubscribers";
 
   RedisPrivate *p;
   MessageConsumer *c, *last = NULL;
@@ -281,7 +535,7 @@ int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f) {
   for(c = p->subscriberList; c != NULL; ) {
     MessageConsumer *next = c->next;
 
-    if(c->func == f) {
+    if(c->func == f && c->owner == owner) {
       if(last) last->next = next;
       else p->subscriberList = next;
 
@@ -295,6 +549,8 @@ int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f) {
     c = next;
   }
 
+  if(removed) rUpdateSubscriberIndexAsync(p);
+
   rSubscriberUnlock(redis);
 
   xvprintf("Redis-X> Removed %d subscriber callbacks.\n", removed);
@@ -302,6 +558,33 @@ int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f) {
   return removed;
 }
 
+/// \endcond
+
+/**
+ * Removes all instances of a subscribe consumer function from the current list of consumers.
+ * This calls only deactivates the specified processing callback function(s), without
+ * stopping the delivery of associated messages. To stop Redis sending messages that are
+ * no longer being processed, you should also call redisxUnsubscribe() as appropriate.
+ * Subscribers that a cluster registered on its servers, via redisxClusterAddSubscriber(), are
+ * not affected.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \param f         The consumer function to remove from the list of active subscribers.
+ *
+ * \return  The number of instances of f() that have been removed from the list of subscribers.
+ *
+ * \sa redisxAddSubscriber()
+ * @sa redisxClearSubscribers()
+ * @sa redisxUnsubscrive()
+ */
+// cppcheck-suppress constParameter
+// cppcheck-suppress constParameterPointer
+int redisxRemoveSubscribers(Redis *redis, RedisSubscriberCall f) {
+  int n = rRemoveSubscribers(redis, f, NULL);
+  prop_error("redisxRemoveSubscribers", n);
+  return n;
+}
+
 /**
  * Stops the custom consumption of PUB/SUB messages from Redis.
  *
@@ -320,10 +603,12 @@ int redisxClearSubscribers(Redis *redis) {
   p = (RedisPrivate *) redis->priv;
   c = p->subscriberList;
   p->subscriberList = NULL;
+  rUpdateSubscriberIndexAsync(p);
   rSubscriberUnlock(redis);
 
   while(c != NULL) {
     MessageConsumer *next = c->next;
+    if(c->channelStem) free(c->channelStem);
     free(c);
     c = next;
     n++;
@@ -358,11 +643,31 @@ int redisxClearSubscribers(Redis *redis) {
 int redisxSubscribe(Redis *redis, const char *pattern) {
   static const char *fn = "redisxSubscribe";
 
+  if(pattern == NULL) return x_error(X_NULL, EINVAL, fn, "pattern parameter is NULL");
+
+  prop_error(fn, rSendSubscriptionCommand(redis, redisxIsGlobPattern(pattern) ? "PSUBSCRIBE" : "SUBSCRIBE", pattern));
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Sends a subscription command (such as `SUBSCRIBE` or `SSUBSCRIBE`) for a channel on the subscription client,
+ * connecting the subscription client and starting the subscription listener first, as necessary.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param command       The subscription command, e.g. "SSUBSCRIBE"
+ * \param channel       The channel or pattern argument of the command.
+ *
+ * \return      X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+int rSendSubscriptionCommand(Redis *redis, const char *command, const char *channel) {
+  static const char *fn = "rSendSubscriptionCommand";
+
   const ClientPrivate *cp;
   int status = 0;
 
-  if(pattern == NULL) return x_error(X_NULL, EINVAL, fn, "pattern parameter is NULL");
-
   // connect subscription client as needed.
   prop_error(fn, rConfigLock(redis));
   cp = (ClientPrivate *) redis->subscription->priv;
@@ -376,13 +681,15 @@ int redisxSubscribe(Redis *redis, const char *pattern) {
   prop_error(fn, status);
 
   prop_error(fn, redisxLockConnected(redis->subscription));
-  status = redisxSendRequestAsync(redis->subscription, redisxIsGlobPattern(pattern) ? "PSUBSCRIBE" : "SUBSCRIBE", pattern, NULL, NULL);
+  status = redisxSendRequestAsync(redis->subscription, command, channel, NULL, NULL);
   redisxUnlockClient(redis->subscription);
   prop_error(fn, status);
 
   return X_SUCCESS;
 }
 
+/// \endcond
+
 /**
  * Unsubscribe from one or all Redis PUB/SUB channel(s). If there are no active subscriptions
  * when Redis confirms the unsubscrive command, the subscription listener thread will also conclude
@@ -441,14 +748,15 @@ static int rEndSubscriptionAsync(Redis *redis) {
   RedisPrivate *p;
   int status;
 
+  prop_error(fn, redisxCheckValid(redis));
+
   xvprintf("Redis-X> End all subscriptions, and quit listener.\n");
 
   status = redisxUnsubscribe(redis, NULL);
 
-  prop_error(fn, rConfigLock(redis));
+  // The caller holds the configuration lock already.
   p = (RedisPrivate *) redis->priv;
   p->isSubscriptionListenerEnabled = FALSE;
-  rConfigUnlock(redis);
 
   rCloseClient(redis->subscription);
   prop_error(fn, status);
@@ -480,47 +788,415 @@ int redisxEndSubscription(Redis *redis) {
   return X_SUCCESS;
 }
 
+/**
+ * Delivers a PUB/SUB message to all subscribers whose channel stem matches the channel. The subscribers
+ * are looked up from the subscriber index without locking or allocating memory, by walking the prefix
+ * trie along the channel name.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param pattern       The subscription pattern that matched the channel, or NULL.
+ * \param channel       The channel on which the message was published.
+ * \param msg           The message
+ * \param length        [bytes] The message length.
+ */
 static void rNotifyConsumers(Redis *redis, char *pattern, char *channel, char *msg, int length) {
-  MessageConsumer *c;
-  RedisPrivate *p;
-  RedisSubscriberCall *f = NULL;
-  int n = 0;
+  RedisPrivate *p = (RedisPrivate *) redis->priv;
+  const SubscriberTrie *t;
+  const char *c;
 
   xvprintf("NOTIFY: %s | %s\n", channel, msg);
 
-  if(rSubscriberLock(redis) != X_SUCCESS) return;
-  p = (RedisPrivate *) redis->priv;
+  __atomic_add_fetch(&p->subscriberReaders, 1, __ATOMIC_SEQ_CST);
 
-  // Count how many matching subscribers there are...
-  for(c = p->subscriberList ; c != NULL; c = c->next) {
-    if(c->channelStem != NULL) if(strncmp(c->channelStem, channel, strlen(c->channelStem))) continue;
-    n++;
+  t = __atomic_load_n(&p->subscriberIndex, __ATOMIC_SEQ_CST);
+
+  for(c = channel; t != NULL; c++) {
+    const char *k;
+    int i;
+
+    // Subscribers whose stem matches the channel up to here...
+    for(i = 0; i < t->n_calls; i++) t->calls[i](pattern, channel, msg, length);
+
+    if(*c == '\0') break;
+
+    k = t->n_next ? (const char *) memchr(t->keys, *c, t->n_next) : NULL;
+    t = k ? t->next[k - t->keys] : NULL;
   }
 
-  if(n) {
-    // Put matching subscribers into an array...
-    f = (RedisSubscriberCall *) calloc(n, sizeof(*f));
-    x_check_alloc(f);
+  __atomic_sub_fetch(&p->subscriberReaders, 1, __ATOMIC_SEQ_CST);
+}
+
+/// \cond PRIVATE
+
+/**
+ * The thread routine of a subscriber dispatch worker. It delivers the messages from its queue to the
+ * subscribers, in the order they were queued, until it is stopped.
+ *
+ * @param pWorker   Pointer to the worker.
+ * @return          Always NULL
+ */
+static void *SubscriberWorkerThread(void *pWorker) {
+  SubscriberWorker *w = (SubscriberWorker *) pWorker;
+
+  for(;;) {
+    SubscriberMessage *m;
+
+    pthread_mutex_lock(&w->mutex);
+    while(!w->count && !w->stop) pthread_cond_wait(&w->notEmpty, &w->mutex);
 
-    n = 0;
-    for(c = p->subscriberList ; c != NULL; c = c->next) {
-      if(c->channelStem != NULL) if(strncmp(c->channelStem, channel, strlen(c->channelStem))) continue;
-      f[n++] = c->func;
+    if(!w->count) {
+      // Stopped, and nothing more to deliver.
+      pthread_mutex_unlock(&w->mutex);
+      break;
     }
+
+    m = w->queue[w->head];
+    w->head = (w->head + 1) % w->size;
+    w->count--;
+
+    pthread_cond_signal(&w->notFull);
+    pthread_mutex_unlock(&w->mutex);
+
+    rNotifyConsumers(w->pool->redis, m->pattern, m->channel, m->msg, m->length);
+    free(m);
   }
 
-  rSubscriberUnlock(redis);
+  return NULL;
+}
 
-  // If there were matching subscribers, call them...
-  if(n) {
-    int i;
-    for(i=0; i<n; i++) f[i](pattern, channel, msg, length);
-    free(f);
+/**
+ * Creates and starts a pool of subscriber dispatch workers.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param n         Number of worker threads
+ * @param size      Number of messages that may wait in the queue of each worker.
+ * @param drop      Whether to drop messages if a queue is full, rather than wait.
+ * @return          The new worker pool, or NULL if there was an error.
+ */
+static SubscriberPool *rCreateSubscriberPool(Redis *redis, int n, int size, boolean drop) {
+  static const char *fn = "rCreateSubscriberPool";
+
+  SubscriberPool *pool;
+  int i;
+
+  pool = (SubscriberPool *) calloc(1, sizeof(SubscriberPool));
+  x_check_alloc(pool);
+
+  pool->workers = (SubscriberWorker *) calloc(n, sizeof(SubscriberWorker));
+  x_check_alloc(pool->workers);
+
+  pool->redis = redis;
+  pool->drop = drop;
+
+  for(i = 0; i < n; i++) {
+    SubscriberWorker *w = &pool->workers[i];
+
+    w->pool = pool;
+    w->size = size;
+    w->queue = (SubscriberMessage **) calloc(size, sizeof(SubscriberMessage *));
+    x_check_alloc(w->queue);
+
+    pthread_mutex_init(&w->mutex, NULL);
+    pthread_cond_init(&w->notEmpty, NULL);
+    pthread_cond_init(&w->notFull, NULL);
+
+    if(pthread_create(&w->tid, NULL, SubscriberWorkerThread, w) != 0) {
+      x_error(0, errno, fn, "failed to start subscriber worker %d", i);
+      pthread_mutex_destroy(&w->mutex);
+      pthread_cond_destroy(&w->notEmpty);
+      pthread_cond_destroy(&w->notFull);
+      free(w->queue);
+      break;
+    }
+
+    pool->n++;
+  }
+
+  if(pool->n == 0) {
+    free(pool->workers);
+    free(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/**
+ * Queues a PUB/SUB message for delivery by the worker that serves the channel. If the worker's queue
+ * is full, the message is either dropped or the call waits until there is room, according to the
+ * pool's policy. Event loop threads, which service many clients, never wait however, and drop the
+ * message instead.
+ *
+ * @param pool      The subscriber dispatch worker pool
+ * @param pattern   The subscription pattern that matched the channel, or NULL.
+ * @param channel   The channel on which the message was published.
+ * @param msg       The message, or NULL.
+ * @param length    [bytes] The message length.
+ */
+static void rQueueMessage(SubscriberPool *pool, const char *pattern, const char *channel, const char *msg, int length) {
+  SubscriberWorker *w;
+  SubscriberMessage *m;
+  unsigned int hash = 2166136261U;
+  size_t lp, lc;
+  const char *c;
+  char *next;
+
+  // FNV-1a hash of the channel, to select the worker
+  for(c = channel; *c; c++) hash = (hash ^ (unsigned char) *c) * 16777619U;
+  w = &pool->workers[hash % pool->n];
+
+  if(!msg || length < 0) length = 0;
+
+  lp = pattern ? strlen(pattern) + 1 : 0;
+  lc = strlen(channel) + 1;
+
+  m = (SubscriberMessage *) malloc(sizeof(SubscriberMessage) + lp + lc + length + 1);
+  x_check_alloc(m);
+
+  next = (char *) (m + 1);
+
+  m->pattern = pattern ? next : NULL;
+  if(pattern) memcpy(next, pattern, lp);
+  next += lp;
+
+  m->channel = next;
+  memcpy(next, channel, lc);
+  next += lc;
+
+  m->msg = msg ? next : NULL;
+  if(msg) memcpy(next, msg, length);
+  next[length] = '\0';
+  m->length = length;
+
+  pthread_mutex_lock(&w->mutex);
+
+  while(w->count == w->size) {
+    if(pool->drop || rIsEventLoopThread()) {
+      pthread_mutex_unlock(&w->mutex);
+      free(m);
+      if(__atomic_add_fetch(&pool->dropped, 1, __ATOMIC_RELAXED) == 1) x_warn("rQueueMessage", "Subscriber queue is full. Dropping messages.\n");
+      return;
+    }
+    pthread_cond_wait(&w->notFull, &w->mutex);
+  }
+
+  w->queue[(w->head + w->count++) % w->size] = m;
+
+  pthread_cond_signal(&w->notEmpty);
+  pthread_mutex_unlock(&w->mutex);
+}
+
+/**
+ * Delivers a PUB/SUB message to the matching subscribers, either directly, or via the subscriber dispatch
+ * workers if configured.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param pattern       The subscription pattern that matched the channel, or NULL.
+ * \param channel       The channel on which the message was published.
+ * \param msg           The message
+ * \param length        [bytes] The message length.
+ */
+static void rDeliverMessage(Redis *redis, char *pattern, char *channel, char *msg, int length) {
+  RedisPrivate *p = (RedisPrivate *) redis->priv;
+  SubscriberPool *pool = __atomic_load_n(&p->subscriberPool, __ATOMIC_ACQUIRE);
+
+  if(pool) rQueueMessage(pool, pattern, channel, msg, length);
+  else rNotifyConsumers(redis, pattern, channel, msg, length);
+}
+
+/**
+ * Stops the subscriber dispatch workers of a Redis instance, after they delivered all messages waiting
+ * in their queues, and frees up the resources used by them.
+ *
+ * @param p     The private data of a Redis instance.
+ */
+void rDestroySubscriberPool(RedisPrivate *p) {
+  SubscriberPool *pool = __atomic_exchange_n(&p->subscriberPool, NULL, __ATOMIC_SEQ_CST);
+  int i;
+
+  if(!pool) return;
+
+  for(i = 0; i < pool->n; i++) {
+    SubscriberWorker *w = &pool->workers[i];
+    pthread_mutex_lock(&w->mutex);
+    w->stop = TRUE;
+    pthread_cond_broadcast(&w->notEmpty);
+    pthread_mutex_unlock(&w->mutex);
+  }
+
+  for(i = 0; i < pool->n; i++) {
+    SubscriberWorker *w = &pool->workers[i];
+
+    pthread_join(w->tid, NULL);
+
+    pthread_mutex_destroy(&w->mutex);
+    pthread_cond_destroy(&w->notEmpty);
+    pthread_cond_destroy(&w->notFull);
+    free(w->queue);
+  }
+
+  if(pool->dropped) xvprintf("Redis-X> Subscriber workers dropped %ld messages.\n", pool->dropped);
+
+  free(pool->workers);
+  free(pool);
+}
+
+/// \endcond
+
+/**
+ * Sets up a pool of threads to dispatch PUB/SUB messages to subscribers, so that slow subscriber callbacks
+ * do not hold up the processing of incoming messages. By default, messages are delivered directly from the
+ * thread that receives them. With workers, each message is queued for the worker that serves its channel
+ * (by hash), so messages on the same channel are still delivered in the order they were received, while
+ * messages on different channels may be delivered concurrently. Subscriber callbacks must therefore be
+ * thread-safe when using more than one worker.
+ *
+ * The setting can be changed only while the subscription client is not connected. The workers are started
+ * when subscribing, and stopped when the Redis instance is destroyed.
+ *
+ * \param redis           Pointer to a Redis instance.
+ * \param n               Number of worker threads, or &lt;=0 to deliver messages directly (default).
+ * \param queueLength     Number of messages that may wait for each worker, or &lt;=0 to use the default
+ *                        REDISX_SUBSCRIBER_QUEUE_LENGTH.
+ * \param dropOnOverflow  Whether to drop incoming messages when a worker's queue is full. Otherwise, the
+ *                        processing of incoming messages waits until there is room in the queue. Messages
+ *                        received by the shared event loop (which must not wait) are always dropped when the
+ *                        queue is full, however.
+ * \return                X_SUCCESS (0) if successful, or else X_ALREADY_OPEN if the subscription client is
+ *                        connected, or another error code &lt;0 (such as X_NULL or X_NO_INIT) if the redis
+ *                        instance is invalid.
+ *
+ * @sa redisxAddSubscriber()
+ * @sa redisxSubscribe()
+ */
+int redisxSetSubscriberWorkers(Redis *redis, int n, int queueLength, boolean dropOnOverflow) {
+  static const char *fn = "redisxSetSubscriberWorkers";
+
+  RedisPrivate *p;
+  const ClientPrivate *sp;
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+
+  sp = (ClientPrivate *) redis->subscription->priv;
+  if(sp->isEnabled) {
+    rConfigUnlock(redis);
+    return x_error(X_ALREADY_OPEN, EISCONN, fn, "cannot change subscriber workers while subscribed");
   }
+
+  p->config.subscriberWorkers = n > 0 ? n : 0;
+  p->config.subscriberQueue = queueLength > 0 ? queueLength : REDISX_SUBSCRIBER_QUEUE_LENGTH;
+  p->config.dropMessages = dropOnOverflow ? TRUE : FALSE;
+
+  // Workers will be (re)started with the new settings when subscribing next.
+  rDestroySubscriberPool(p);
+
+  rConfigUnlock(redis);
+
+  return X_SUCCESS;
 }
 
 /// \cond PRIVATE
 
+/**
+ * Processes a response received on the subscription client, delivering PUB/SUB messages to the matching
+ * subscribers.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param reply         The response received on the subscription client. It remains owned by the caller.
+ */
+void rProcessSubscriptionReply(Redis *redis, RESP *reply) {
+  static long lastError;
+
+  const RedisPrivate *p = (RedisPrivate *) redis->priv;
+  RESP **component;
+  int i;
+
+  if(reply->n < 0) {
+    if(reply->n != lastError) fprintf(stderr, "ERROR! Redis-X : subscriber parse error: %d.\n", reply->n);
+    lastError = reply->n;
+    return;
+  }
+
+  if(p->cluster && redisxClusterMoved(reply)) {
+    // A sharded subscription was redirected to another node. Resubscribe after reconfiguring.
+    rClusterShardUnsubscribed(p->cluster, redis, NULL);
+    return;
+  }
+
+  if(reply->type != RESP_ARRAY) {
+    fprintf(stderr, "WARNING! Redis-X : unexpected subscriber response type: '%c'.\n", reply->type);
+    return;
+  }
+
+  component = (RESP **) reply->value;
+
+  lastError = 0;
+
+  // Check that the response has a valid array dimension
+  if(reply->n < 3 || reply->n > 4) {
+    fprintf(stderr, "WARNING! Redis-X: unexpected number of components in subscriber response: %d.\n", reply->n);
+    return;
+  }
+
+  // Check for NULL component (all except last -- the payload -- which may be NULL)
+  for(i=reply->n-1; --i >= 0; ) if(component[i] == NULL) {
+    fprintf(stderr, "WARNING! Redis-X : subscriber NULL in component %d\n", (i+1));
+    return;
+  }
+
+  if(!strcmp("message", (char *) component[0]->value)) {
+    // Send the message to the matching subscribers or warn if invalid....
+    if(reply->n == 3)
+      rDeliverMessage(redis, NULL, (char *) component[1]->value, (char *) component[2]->value, component[2]->n);
+    else fprintf(stderr, "WARNING! Redis-X: unexpected subscriber message dimension: %d.\n", reply->n);
+  }
+
+  else if(!strcmp("pmessage", (char *) component[0]->value)) {
+    // Send the message to the matching subscribers or warn if invalid....
+    if(reply->n == 4)
+      rDeliverMessage(redis, (char *) component[1]->value, (char *) component[2]->value, (char *) component[3]->value, component[3]->n);
+    else fprintf(stderr, "WARNING! Redis-X: unexpected subscriber pmessage dimension: %d.\n", reply->n);
+  }
+
+  else if(!strcmp("smessage", (char *) component[0]->value)) {
+    // Sharded message, delivered the same way as regular messages...
+    if(reply->n == 3)
+      rDeliverMessage(redis, NULL, (char *) component[1]->value, (char *) component[2]->value, component[2]->n);
+    else fprintf(stderr, "WARNING! Redis-X: unexpected subscriber smessage dimension: %d.\n", reply->n);
+  }
+
+  else if(!strcmp("sunsubscribe", (char *) component[0]->value)) {
+    // The server also unsubscribes sharded channels when their hash slot migrates to another shard.
+    if(p->cluster && reply->n > 1 && component[1]->value) rClusterShardUnsubscribed(p->cluster, redis, (char *) component[1]->value);
+  }
+
+  //    else if(!strcmp("unsubscribe", (char *) component[0]->value)) if(component[2]->n <= 0) {
+  //      xvprintf("Redis-X> no more subscriptions.\n");
+  //
+  //      // if unsubscribe, and no subscribers left, then exit the listener...
+  //      // !!! THIS IS DANGEROUS !!! -- because we can have a concurrent subscribe that will think
+  //      // listener is alive, just as we are about to kill it. It's safer to keep it running...
+  //      //break;
+  //    }
+}
+
+/**
+ * Delivers a PUB/SUB message, located in the receive buffer of the subscription client, to the matching
+ * subscribers. Unlike rProcessSubscriptionReply(), no RESP is needed for the message.
+ *
+ * \param redis         Pointer to a Redis instance.
+ * \param part          The `\0` terminated components of the message (e.g. "message", channel, and payload).
+ * \param len           [bytes] The lengths of the components
+ * \param n             The number of components: 3 for `message` or `smessage`, and 4 for `pmessage`.
+ *
+ * @sa rReadMessageAsync()
+ */
+void rProcessSubscriptionMessage(Redis *redis, char **part, const int *len, int n) {
+  if(n == 4) rDeliverMessage(redis, part[1], part[2], part[3], len[3]);
+  else rDeliverMessage(redis, NULL, part[1], part[2], len[2]);
+}
+
 /**
  * This is the subscription client thread listener routine. It is started by redisScubscribe(), and stopped
  * when Redis confirms that there are no active subscriptions following an 'unsubscribe' request.
@@ -531,14 +1207,14 @@ static void rNotifyConsumers(Redis *redis, char *pattern, char *channel, char *m
  *
  */
 void *RedisSubscriptionListener(void *pRedis) {
-  static long counter, lastError;
+  static long counter;
 
   Redis *redis = (Redis *) pRedis;
   RedisPrivate *p;
   RedisClient *cl;
   const ClientPrivate *cp;
-  RESP *reply = NULL, **component;
-  int i;
+  RESP *reply = NULL;
+  int status;
 
   pthread_detach(pthread_self());
 
@@ -553,62 +1229,19 @@ void *RedisSubscriptionListener(void *pRedis) {
   while(cp->isEnabled && p->isSubscriptionListenerEnabled && pthread_equal(p->subscriptionListenerTID, pthread_self())) {
     // Discard the response from the prior iteration
     if(reply) redisxDestroyRESP(reply);
+    reply = NULL;
 
-    // Get the new response...
-    reply = redisxReadReplyAsync(cl, NULL);
-    if(!reply) continue;
-
-    counter++;
-
-    if(reply->n < 0) {
-      if(reply->n != lastError) fprintf(stderr, "ERROR! Redis-X : subscriber parse error: %d.\n", reply->n);
-      lastError = reply->n;
-      continue;
-    }
-
-    if(reply->type != RESP_ARRAY) {
-      fprintf(stderr, "WARNING! Redis-X : unexpected subscriber response type: '%c'.\n", reply->type);
-      continue;
-    }
-
-    component = (RESP **) reply->value;
-
-    lastError = 0;
+    // Deliver messages straight from the receive buffer, or else get the new response...
+    status = rReadMessageAsync(cl);
+    if(status < 0) continue;
 
-    // Check that the response has a valid array dimension
-    if(reply->n < 3 || reply->n > 4) {
-      fprintf(stderr, "WARNING! Redis-X: unexpected number of components in subscriber response: %d.\n", reply->n);
-      continue;
-    }
-
-    // Check for NULL component (all except last -- the payload -- which may be NULL)
-    for(i=reply->n-1; --i >= 0; ) if(component[i] == NULL) {
-      fprintf(stderr, "WARNING! Redis-X : subscriber NULL in component %d\n", (i+1));
-      continue;
-    }
-
-    if(!strcmp("message", (char *) component[0]->value)) {
-      // Send the message to the matching subscribers or warn if invalid....
-      if(reply->n == 3)
-        rNotifyConsumers(redis, NULL, (char *) component[1]->value, (char *) component[2]->value, component[2]->n);
-      else fprintf(stderr, "WARNING! Redis-X: unexpected subscriber message dimension: %d.\n", reply->n);
+    if(status == 0) {
+      reply = redisxReadReplyAsync(cl, NULL);
+      if(!reply) continue;
+      rProcessSubscriptionReply(redis, reply);
     }
 
-    else if(!strcmp("pmessage", (char *) component[0]->value)) {
-      // Send the message to the matching subscribers or warn if invalid....
-      if(reply->n == 4)
-        rNotifyConsumers(redis, (char *) component[1]->value, (char *) component[2]->value, (char *) component[3]->value, component[3]->n);
-      else fprintf(stderr, "WARNING! Redis-X: unexpected subscriber pmessage dimension: %d.\n", reply->n);
-    }
-
-    //    else if(!strcmp("unsubscribe", (char *) component[0]->value)) if(component[2]->n <= 0) {
-    //      xvprintf("Redis-X> no more subscriptions.\n");
-    //
-    //      // if unsubscribe, and no subscribers left, then exit the listener...
-    //      // !!! THIS IS DANGEROUS !!! -- because we can have a concurrent subscribe that will think
-    //      // listener is alive, just as we are about to kill it. It's safer to keep it running...
-    //      //break;
-    //    }
+    counter++;
 
 #if REDISX_LISTENER_YIELD_COUNT > 0
     // Allow the waiting processes to take control...
@@ -650,6 +1283,16 @@ static int rStartSubscriptionListenerAsync(Redis *redis) {
 
   p->isSubscriptionListenerEnabled = TRUE;
 
+  // Start the subscriber dispatch workers, if configured.
+  if(p->config.subscriberWorkers > 0 && !p->subscriberPool) {
+    int size = p->config.subscriberQueue > 0 ? p->config.subscriberQueue : REDISX_SUBSCRIBER_QUEUE_LENGTH;
+    __atomic_store_n(&p->subscriberPool, rCreateSubscriberPool(redis, p->config.subscriberWorkers, size, p->config.dropMessages), __ATOMIC_RELEASE);
+  }
+
+  // Use the shared event loop, if configured and running...
+  if(p->config.useEventLoop && redisxIsEventLoopRunning())
+    if(rLoopAddClientAsync(redis->subscription) == X_SUCCESS) return 0;
+
   if (pthread_create(&p->subscriptionListenerTID, NULL, RedisSubscriptionListener, redis) == -1) {
     perror("ERROR! Redis-X : pthread_create SubscriptionListener");
     p->isSubscriptionListenerEnabled = FALSE;
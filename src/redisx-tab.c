@@ -12,13 +12,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include "redisx-priv.h"
 
 #define SCAN_INITIAL_STORE_CAPACITY   256   ///< Number of Redis keys to allocate initially when using SCAN to get list of keywords
 
 /// \cond PRIVATE
-#define SCAN_INITIAL_CURSOR         "0"     ///< Initial cursor value for SCAN command.
+#define SCAN_DEFAULT_COUNT          10      ///< The default COUNT used by Redis for SCAN commands.
+#define SCAN_MIN_COUNT              10      ///< Smallest COUNT to use when adapting to the target page latency.
+#define SCAN_MAX_COUNT              100000  ///< Largest COUNT to use when adapting to the target page latency.
+#define DELETE_BATCH_SIZE           1000    ///< Maximum number of keys or fields to delete with a single command.
 
 #if FNMATCH || _POSIX_C_SOURCE >= 200112L
 // fnmatch() is POSIX-1.2001
@@ -136,10 +140,15 @@ int redisxSetValue(Redis *redis, const char *table, const char *key, const char
     redisxDestroyRESP(reply);
   }
   else {
+    RedisClient *cl;
+
     if(redis == NULL) return x_error(X_NULL, EINVAL, fn, "redis is NULL");
-    prop_error(fn, redisxLockConnected(redis->interactive));
-    status = redisxSetValueAsync(redis->interactive, table, key, value, FALSE);
-    redisxUnlockClient(redis->interactive);
+
+    cl = rLockInteractive(redis, &status);
+    if(!cl) return x_trace(fn, NULL, status);
+
+    status = redisxSetValueAsync(cl, table, key, value, FALSE);
+    redisxUnlockClient(cl);
   }
 
   prop_error(fn, status);
@@ -280,6 +289,56 @@ char *redisxGetStringValue(Redis *redis, const char *table, const char *key, int
   return str;
 }
 
+/**
+ * Retrieve a variable from Redis directly into the caller's buffer, through the interactive connection. Unlike
+ * redisxGetValue() or redisxGetStringValue(), the value is not copied into newly allocated storage, and large values
+ * are received from the socket straight into the supplied buffer. As such it is the preferred way for retrieving
+ * large (e.g. binary) values repeatedly, using the same buffer.
+ *
+ * The call effectively implements a Redis GET (if the table argument is NULL) or HGET call. Unlike redisxGetValue(),
+ * it does not follow cluster MOVED or ASK redirections, which are reported as REDIS_UNEXPECTED_RESP instead.
+ *
+ * \param[in]  redis     Pointer to a Redis instance.
+ * \param[in]  table     Hashtable from which to retrieve a value or NULL if to use the global table.
+ * \param[in]  key       Field name (i.e. variable name).
+ * \param[out] buf       Buffer into which to read the value.
+ * \param[in]  size      (bytes) Size of the buffer. Longer values are truncated to fit.
+ *
+ * \return      The full length (&gt;=0) of the value, which may exceed the buffer size, or else REDIS_NULL if
+ *              there is no such value, or else another error code (&lt;0) from redisx.h / xchange.h.
+ *
+ * \sa redisxGetValue()
+ * \sa redisxReadBulkStringAsync()
+ */
+int redisxGetValueInto(Redis *redis, const char *table, const char *key, char *buf, int size) {
+  static const char *fn = "redisxGetValueInto";
+
+  RedisClient *cl;
+  int status;
+
+  if(table && !table[0]) return x_error(X_GROUP_INVALID, EINVAL, fn, "'table' parameter is empty");
+  if(key == NULL) return x_error(X_NAME_INVALID, EINVAL, fn, "'key' parameter is NULL");
+  if(!key[0]) return x_error(X_NAME_INVALID, EINVAL, fn, "'key' parameter is empty");
+  if(buf == NULL) return x_error(X_NULL, EINVAL, fn, "'buf' parameter is NULL");
+
+  prop_error(fn, redisxCheckValid(redis));
+
+  cl = rLockInteractive(redis, &status);
+  if(!cl) return x_trace(fn, NULL, status);
+
+  if(table == NULL) status = redisxSendRequestAsync(cl, "GET", key, NULL, NULL);
+  else status = redisxSendRequestAsync(cl, "HGET", table, key, NULL);
+
+  if(status == X_SUCCESS) status = redisxReadBulkStringAsync(cl, buf, size);
+
+  redisxUnlockClient(cl);
+
+  if(status == REDIS_NULL) return REDIS_NULL;
+  prop_error(fn, status);
+
+  return status;
+}
+
 /**
  * Checks the input parameters for setting multiple entries at once in a Redis hash table.
  *
@@ -572,10 +631,446 @@ int redisxGetScanCount(Redis *redis) {
   return count;
 }
 
+/**
+ * Sets a target latency for the individual pages of SCAN-type queries. When set, the COUNT argument of successive
+ * scan queries is adjusted on the fly: doubled while pages return in less than half the target time, and halved
+ * when a page takes longer than the target. The COUNT arrived at is retained (see redisxGetScanCount()) as the
+ * starting point for subsequent scans. Setting a target thus lets large scans complete in fewer round trips,
+ * without letting individual queries hog the server.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param micros    [us] The target latency for receiving a page of scan results, or &lt;=0 to disable adapting
+ *                  the COUNT (default).
+ * @return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                  or X_NO_INIT if the redis instance is not initialized.
+ *
+ * @sa redisxSetScanCount()
+ * @sa redisxSetScanPrefetch()
+ */
+int redisxSetScanTargetLatency(Redis *redis, int micros) {
+  RedisPrivate *p;
+
+  prop_error("redisxSetScanTargetLatency", rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->scanTargetMicros = micros > 0 ? micros : 0;
+  rConfigUnlock(redis);
+
+  return X_SUCCESS;
+}
+
+/**
+ * Enables or disables prefetching pages in redisxScanKeys() and redisxScanTable(). When enabled, the request for
+ * the next page of results is sent as soon as a page arrives, so the server works on it while the client processes
+ * the current page, hiding one round trip per page. To do so, the scan keeps an interactive connection locked for
+ * its duration, which blocks other interactive queries (from other threads) on the same connection until the scan
+ * completes, unless a pool of interactive connections is used.
+ *
+ * @param redis     Pointer to a Redis instance.
+ * @param value     TRUE (non-zero) to prefetch scan pages, or FALSE (0) to request them one at a time (default).
+ * @return          X_SUCCESS (0) if successful, or else X_NULL if the redis instance is NULL,
+ *                  or X_NO_INIT if the redis instance is not initialized.
+ *
+ * @sa redisxSetScanTargetLatency()
+ * @sa redisxScanKeys()
+ * @sa redisxScanTable()
+ */
+int redisxSetScanPrefetch(Redis *redis, boolean value) {
+  RedisPrivate *p;
+
+  prop_error("redisxSetScanPrefetch", rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  p->scanPrefetch = value ? TRUE : FALSE;
+  rConfigUnlock(redis);
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * The state of a SCAN-type (e.g. `SCAN` or `HSCAN`) iteration, which retrieves one page at a time.
+ */
+typedef struct {
+  Redis *redis;                 ///< The Redis instance to scan
+  const char *cmd[7];           ///< The command arguments
+  int args;                     ///< Number of command arguments
+  int cursorIdx;                ///< Index of the cursor argument in cmd
+  char countArg[20];            ///< Storage for the COUNT argument
+  boolean done;                 ///< Whether the cursor has returned to the start.
+  RESP *page;                   ///< The last page received
+  RedisClient *cl;              ///< Interactive client locked for prefetching pages, or NULL
+  boolean inFlight;             ///< Whether the request for the next page has been sent already
+  struct timespec sent;         ///< Time the request for the next page was sent
+  int count;                    ///< The current COUNT argument, or &lt;=0 if not set.
+  int targetMicros;             ///< [us] Target page latency for adapting COUNT, or &lt;=0 to keep COUNT fixed.
+} RedisScan;
+
+/**
+ * A slot in a set of keys.
+ */
+typedef struct {
+  uint64_t hash;                ///< 64-bit hash of the key, or 0 if the slot is empty.
+  char *key;                    ///< A copy of the key
+  int length;                   ///< [bytes] Length of the key
+} RedisHashSlot;
+
+/**
+ * A set of keys, indexed by their 64-bit hashes, for removing duplicates from scan results as they arrive.
+ */
+typedef struct {
+  RedisHashSlot *slot;          ///< Open addressing table of keys.
+  int capacity;                 ///< Size of the table (a power of 2)
+  int n;                        ///< Number of keys in the set
+} RedisHashSet;
+
+/**
+ * Private state of a table iterator
+ */
+typedef struct {
+  RedisScan scan;               ///< The HSCAN iteration
+  RedisEntry *entries;          ///< Entries of the current page, referencing strings in the page.
+  int capacity;                 ///< Number of entries that may be stored without reallocating.
+  RedisHashSet *seen;           ///< Fields returned so far, if removing duplicates, or else NULL.
+} TableIterator;
+
+/**
+ * Initializes a SCAN-type iteration. If prefetching is allowed and enabled for the Redis instance (see
+ * redisxSetScanPrefetch()), an interactive client is locked for the duration of the scan, so the request for
+ * the next page may be sent while the current one is being processed. Thus, it should not be allowed when the
+ * caller may use the same Redis instance between pages.
+ *
+ * @param s               The scan state to initialize
+ * @param redis           Pointer to a Redis instance
+ * @param command         The scan command, e.g. "SCAN" or "HSCAN"
+ * @param table           The hash table to scan, or NULL for a top-level SCAN.
+ * @param pattern         Glob pattern of the keys to match, or NULL to match all keys.
+ * @param allowPrefetch   Whether pages may be prefetched, if enabled for the Redis instance.
+ * @return                X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+static int rScanInit(RedisScan *s, Redis *redis, const char *command, const char *table, const char *pattern, boolean allowPrefetch) {
+  static const char *fn = "rScanInit";
+
+  const RedisPrivate *p;
+  boolean prefetch;
+
+  memset(s, 0, sizeof(RedisScan));
+
+  prop_error(fn, rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
+  s->count = p->scanCount;
+  s->targetMicros = p->scanTargetMicros;
+  prefetch = allowPrefetch && p->scanPrefetch;
+  rConfigUnlock(redis);
+
+  if(prefetch) {
+    int status = X_SUCCESS;
+    s->cl = rLockInteractive(redis, &status);
+    if(!s->cl) return x_trace(fn, NULL, status);
+  }
+
+  // Adapting needs an explicit COUNT, starting from the Redis default.
+  if(s->targetMicros > 0 && s->count <= 0) s->count = SCAN_DEFAULT_COUNT;
+
+  s->redis = redis;
+  s->cmd[s->args++] = command;
+  if(table) s->cmd[s->args++] = table;
+
+  s->cursorIdx = s->args;
+  s->cmd[s->args++] = xStringCopyOf(SCAN_INITIAL_CURSOR);
+
+  if(pattern) {
+    s->cmd[s->args++] = "MATCH";
+    s->cmd[s->args++] = pattern;
+  }
+
+  if(s->count > 0) {
+    sprintf(s->countArg, "%d", s->count);
+    s->cmd[s->args++] = "COUNT";
+    s->cmd[s->args++] = s->countArg;
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Sends the request for the next page of a prefetching SCAN-type iteration.
+ *
+ * @param s         The scan state
+ * @return          X_SUCCESS (0) if successful, or else an error code &lt;0.
+ */
+static int rScanSendAsync(RedisScan *s) {
+  clock_gettime(CLOCK_MONOTONIC, &s->sent);
+  prop_error("rScanSendAsync", redisxSendArrayRequestAsync(s->cl, s->cmd, NULL, s->args));
+  s->inFlight = TRUE;
+  return X_SUCCESS;
+}
+
+/**
+ * Adjusts the COUNT argument of a SCAN-type iteration, based on how long it took to get the last page, towards
+ * the target page latency, if set.
+ *
+ * @param s             The scan state
+ * @param received      The time the last page was received.
+ * @param isUpperBound  Whether the page was waiting already when we got to read it (after prefetching), in
+ *                      which case the actual latency is not known, only that it was no longer than measured.
+ */
+static void rScanAdapt(RedisScan *s, const struct timespec *received, boolean isUpperBound) {
+  long micros;
+
+  if(s->targetMicros <= 0) return;
+
+  micros = 1000000L * (received->tv_sec - s->sent.tv_sec) + (received->tv_nsec - s->sent.tv_nsec) / 1000L;
+
+  if(micros < (s->targetMicros >> 1) && s->count < SCAN_MAX_COUNT) s->count <<= 1;
+  else if(micros > s->targetMicros && s->count > SCAN_MIN_COUNT && !isUpperBound) s->count >>= 1;
+  else return;
+
+  sprintf(s->countArg, "%d", s->count);
+}
+
+/**
+ * Retrieves the next page of a SCAN-type iteration. The prior page is discarded. When prefetching, the request
+ * for the following page is sent as soon as the cursor of this one is parsed, before returning.
+ *
+ * @param s         The scan state
+ * @param[out] n    The number of items in the page.
+ * @return          The items in the page, or NULL if there are none, or if there was an error (n is set to
+ *                  the error code &lt;0).
+ */
+static RESP **rScanNextPage(RedisScan *s, int *n) {
+  RESP **components = NULL;
+  struct timespec received;
+  boolean isWaiting = FALSE;
+  int status = X_SUCCESS;
+
+  redisxDestroyRESP(s->page);
+  s->page = NULL;
+  *n = 0;
+
+  if(s->done) return NULL;
+
+  if(s->cl) {
+    if(!s->inFlight) status = rScanSendAsync(s);
+    else isWaiting = (redisxGetAvailableAsync(s->cl) > 0);   // The prefetched page has (started to) arrive.
+
+    if(!status) {
+      s->inFlight = FALSE;
+      s->page = redisxReadReplyAsync(s->cl, &status);
+    }
+  }
+  else {
+    clock_gettime(CLOCK_MONOTONIC, &s->sent);
+    s->page = redisxArrayRequest(s->redis, s->cmd, NULL, s->args, &status);
+  }
+
+  // The page latency is from sending the request to receiving the reply.
+  clock_gettime(CLOCK_MONOTONIC, &received);
+
+  // We expect an array of 2 elements { cursor, { items } }
+  if(!status) status = redisxCheckRESP(s->page, RESP_ARRAY, 2);
+  if(!status) {
+    components = (RESP **) s->page->value;
+    status = redisxCheckRESP(components[0], RESP_BULK_STRING, 0);
+    if(!status) status = redisxCheckRESP(components[1], RESP_ARRAY, 0);
+  }
+
+  if(status) {
+    s->done = TRUE;
+    *n = status;
+    return NULL;
+  }
+
+  rScanAdapt(s, &received, isWaiting);
+
+  // Use the new cursor for the next request
+  free((char *) s->cmd[s->cursorIdx]);
+  s->cmd[s->cursorIdx] = (char *) components[0]->value;
+  components[0]->value = NULL;        // de-reference cursor from RESP.
+
+  s->done = (strcmp(s->cmd[s->cursorIdx], SCAN_INITIAL_CURSOR) == 0);  // Done when cursor is back to 0...
+
+  // Get the next page on its way, while the caller processes this one.
+  if(s->cl && !s->done) {
+    status = rScanSendAsync(s);
+    if(status) {
+      s->done = TRUE;
+      *n = status;
+      return NULL;
+    }
+  }
+
+  *n = components[1]->n;
+  return (RESP **) components[1]->value;
+}
+
+/**
+ * Releases the resources used by a SCAN-type iteration, and unlocks the client used for prefetching (if any).
+ * If the COUNT argument was adapted, the final value is kept as the scan count of the Redis instance (see
+ * redisxSetScanCount()).
+ *
+ * @param s     The scan state
+ */
+static void rScanDestroy(RedisScan *s) {
+  redisxDestroyRESP(s->page);
+  free((char *) s->cmd[s->cursorIdx]);
+
+  if(s->cl) {
+    // Consume the reply to the request still in flight, if any.
+    if(s->inFlight) redisxIgnoreReplyAsync(s->cl);
+    redisxUnlockClient(s->cl);
+  }
+
+  if(s->targetMicros > 0 && rConfigLock(s->redis) == X_SUCCESS) {
+    RedisPrivate *p = (RedisPrivate *) s->redis->priv;
+    p->scanCount = s->count;
+    rConfigUnlock(s->redis);
+  }
+
+  memset(s, 0, sizeof(RedisScan));
+}
+
+/**
+ * Returns a 64-bit hash of a string (FNV-1a, followed by a final mix), which is never zero.
+ *
+ * @param str     The string
+ * @param len     [bytes] String length
+ * @return        The 64-bit hash (non-zero).
+ */
+static uint64_t rHash64(const char *str, int len) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  int i;
+
+  for(i = 0; i < len; i++) h = (h ^ (unsigned char) str[i]) * 0x100000001b3ULL;
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+
+  return h ? h : 1;
+}
+
+/**
+ * Returns the slot in which a key with the given hash is stored, or else the empty slot in which it should be
+ * stored.
+ *
+ * @param set     The hash set (with capacity &gt;0)
+ * @param h       The hash of the key (non-zero)
+ * @param key     The key
+ * @param len     [bytes] The length of the key
+ * @return        The slot of the matching key, or an empty slot if the key is not in the set.
+ */
+static RedisHashSlot *rHashSetFind(const RedisHashSet *set, uint64_t h, const char *key, int len) {
+  int i;
+
+  for(i = (int) (h & (set->capacity - 1)); set->slot[i].hash; i = (i + 1) & (set->capacity - 1)) {
+    const RedisHashSlot *s = &set->slot[i];
+
+    // Compare the keys themselves, since different keys may have the same hash also.
+    if(s->hash == h && s->length == len && memcmp(s->key, key, len) == 0) break;
+  }
+
+  return &set->slot[i];
+}
+
+/**
+ * Adds a copy of a key to a hash set, unless it is already in the set.
+ *
+ * @param set     The hash set
+ * @param key     The key to add
+ * @param len     [bytes] The length of the key
+ * @return        TRUE (1) if the key was added, or FALSE (0) if it was in the set already.
+ */
+static boolean rHashSetAdd(RedisHashSet *set, const char *key, int len) {
+  uint64_t h = rHash64(key, len);
+  RedisHashSlot *s;
+  int i;
+
+  if((set->n + 1) << 1 > set->capacity) {
+    // Keep the load at or below 50%, so probe sequences remain short.
+    RedisHashSet bigger = { NULL, set->capacity ? (set->capacity << 1) : 1024, set->n };
+
+    bigger.slot = (RedisHashSlot *) calloc(bigger.capacity, sizeof(RedisHashSlot));
+    x_check_alloc(bigger.slot);
+
+    // Move the keys over (they are all distinct).
+    for(i = 0; i < set->capacity; i++) if(set->slot[i].hash)
+      *rHashSetFind(&bigger, set->slot[i].hash, NULL, -1) = set->slot[i];
+
+    free(set->slot);
+    *set = bigger;
+  }
+
+  s = rHashSetFind(set, h, key, len);
+  if(s->hash) return FALSE;
+
+  s->key = (char *) malloc(len + 1);
+  x_check_alloc(s->key);
+  memcpy(s->key, key, len);
+  s->key[len] = '\0';
+
+  s->hash = h;
+  s->length = len;
+  set->n++;
+
+  return TRUE;
+}
+
+/**
+ * Frees up a hash set, together with the keys in it.
+ *
+ * @param set     The hash set (it may be NULL).
+ */
+static void rHashSetDestroy(RedisHashSet *set) {
+  int i;
+
+  if(!set) return;
+
+  for(i = 0; i < set->capacity; i++) if(set->slot[i].key) free(set->slot[i].key);
+
+  free(set->slot);
+  free(set);
+}
+
+/// \endcond
+
 static int compare_strings(const void *a, const void *b) {
   return strcmp(*(char **) a, *(char **) b);
 }
 
+/// \cond PRIVATE
+
+/**
+ * Sorts an array of keys alphabetically, and removes duplicates (freeing them) in place.
+ *
+ * @param keys    Array of (dynamically allocated) keys
+ * @param n       The number of keys in the array
+ * @return        The number of unique keys remaining at the head of the array.
+ */
+int rSortKeys(char **keys, int n) {
+  int i, j;
+
+  if(n < 2) return n;
+
+  // Sort alphabetically.
+  qsort(keys, n, sizeof(char *), compare_strings);
+
+  // Remove duplicates
+  for(i = n; --i > 0; ) if(!strcmp(keys[i], keys[i-1])) {
+    free(keys[i]);
+    keys[i] = NULL;
+  }
+
+  // Compact...
+  for(i = 0, j = 0; i < n; i++) if(keys[i]) {
+    if(i != j) keys[j] = keys[i];
+    j++;
+  }
+
+  return j;
+}
+
+/// \endcond
+
 /**
  * Returns an alphabetical list of the Redis keys using the Redis SCAN command.
  * Because it uses the scan command, it is guaranteed to not hog the database for excessive periods, and
@@ -605,13 +1100,10 @@ static int compare_strings(const void *a, const void *b) {
 char **redisxScanKeys(Redis *redis, const char *pattern, int *n) {
   static const char *fn = "redisxScanKeys";
 
-  RESP *reply = NULL;
-  const char *cmd[6] = {NULL};
-  char **pCursor;
+  RedisScan scan;
   char **names = NULL;
-  char countArg[20];
   int capacity = SCAN_INITIAL_STORE_CAPACITY;
-  int args = 0, i, j, status = X_SUCCESS;
+  int i, status = X_SUCCESS;
 
   if(n == NULL) {
     x_error(0, EINVAL, fn, "parameter 'n' is NULL");
@@ -620,53 +1112,24 @@ char **redisxScanKeys(Redis *redis, const char *pattern, int *n) {
 
   *n = 0;
 
-  cmd[args++] = "SCAN";
-
-  pCursor = (char **) &cmd[args];
-  cmd[args++] = xStringCopyOf(SCAN_INITIAL_CURSOR);
-
-  if(pattern) {
-    cmd[args++] = "MATCH";
-    cmd[args++] = (char *) pattern;
-  }
-
-  i = redisxGetScanCount(redis);
-  if(i > 0) {
-    sprintf(countArg, "%d", i);
-    cmd[args++] = "COUNT";
-    cmd[args++] = countArg;
+  status = rScanInit(&scan, redis, "SCAN", NULL, pattern, TRUE);
+  if(status) {
+    *n = status;
+    return x_trace_null(fn, NULL);
   }
 
   do {
     int count;
-    RESP **components;
-
-    if(reply) redisxDestroyRESP(reply);
-    reply = redisxArrayRequest(redis, cmd, NULL, args, &status);
-    if(status < 0) break;
-
-    // We expect an array of 2 elements { cursor, { names } }
-    status = redisxCheckRESP(reply, RESP_ARRAY, 2);
-    if(status < 0) break;
-
-    components = (RESP **) reply->value;
-
-    status = redisxCheckRESP(components[0], RESP_BULK_STRING, 0);
-    if(status < 0) break;
+    RESP **components = rScanNextPage(&scan, &count);
 
-    status = redisxCheckRESP(components[1], RESP_ARRAY, 0);
-    if(status < 0) break;
-
-    // Discard previously received cursor...
-    free(*pCursor);
-    *pCursor = (char *) components[0]->value;
-    components[0]->value = NULL;        // de-reference name from RESP.
-
-    count = components[1]->n;
-    components = (RESP **) components[1]->value;
+    if(count < 0) {
+      status = count;
+      break;
+    }
 
     // OK, we got a reasonable response, now make sure we have storage space for it.
     if(!names) {
+      while(count > capacity) capacity <<= 1;
       names = (char **) calloc(capacity, sizeof(char *));
       if(!names) {
         fprintf(stderr, "WARNING! Redis-X : alloc pointers for up to %d keys: %s\n", capacity, strerror(errno));
@@ -676,7 +1139,7 @@ char **redisxScanKeys(Redis *redis, const char *pattern, int *n) {
     else if(*n + count > capacity) {
       char **old = names;
 
-      capacity <<= 1;
+      while(*n + count > capacity) capacity <<= 1;
       names = (char **) realloc(names, capacity * sizeof(char *));
       if(!names) {
         fprintf(stderr, "WARNING! Redis-X : realloc pointers for up to %d keys: %s\n", capacity, strerror(errno));
@@ -694,11 +1157,10 @@ char **redisxScanKeys(Redis *redis, const char *pattern, int *n) {
       components[i]->value = NULL;      // de-reference name from RESP.
     }
 
-  } while (strcmp(*pCursor, SCAN_INITIAL_CURSOR));  // Done when cursor is back to 0...
+  } while(!status && !scan.done);
 
   // Clean up.
-  redisxDestroyRESP(reply);
-  free(*pCursor);
+  rScanDestroy(&scan);
 
   // Check for errors
   if(status) {
@@ -709,22 +1171,7 @@ char **redisxScanKeys(Redis *redis, const char *pattern, int *n) {
 
   if(!names) return NULL;
 
-  // Sort alphabetically.
-  qsort(names, *n, sizeof(char *), compare_strings);
-
-  // Remove duplicates
-  for(i = *n; --i > 0; ) if(!strcmp(names[i], names[i-1])) {
-    free(names[i]);
-    names[i] = NULL;
-  }
-
-  // Compact...
-  for(i = 0, j = 0; i < *n; i++) if(names[i]) {
-    if(i != j) names[j] = names[i];
-    j++;
-  }
-
-  *n = j;
+  *n = rSortKeys(names, *n);
 
   xvprintf("Redis-X> Returning %d scanned / sorted keys (after removing dupes).\n", *n);
 
@@ -768,12 +1215,10 @@ static int compare_entries(const void *a, const void *b) {
 RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern, int *n) {
   static const char *fn = "redisxScanTable";
 
-  RESP *reply = NULL;
+  RedisScan scan;
   RedisEntry *entries = NULL;
-  const char *cmd[7] = {NULL};
-  char countArg[20], **pCursor;
   int capacity = SCAN_INITIAL_STORE_CAPACITY;
-  int args = 0, i, j, status = X_SUCCESS;
+  int i, j, status = X_SUCCESS;
 
   if(n == NULL) {
     x_error(0, EINVAL, fn, "parameter 'n' is NULL");
@@ -792,54 +1237,26 @@ RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern
 
   *n = 0;
 
-  cmd[args++] = "HSCAN";
-  cmd[args++] = (char *) table;
-
-  pCursor = (char **) &cmd[args];
-  cmd[args++] = xStringCopyOf(SCAN_INITIAL_CURSOR);
-
-  if(pattern) {
-    cmd[args++] = "MATCH";
-    cmd[args++] = (char *) pattern;
-  }
-
-  i = redisxGetScanCount(redis);
-  if(i > 0) {
-    sprintf(countArg, "%d", i);
-    cmd[args++] = "COUNT";
-    cmd[args++] = countArg;
+  status = rScanInit(&scan, redis, "HSCAN", table, pattern, TRUE);
+  if(status) {
+    *n = status;
+    return x_trace_null(fn, NULL);
   }
 
   do {
     int count;
-    RESP **components;
-
-    if(reply) redisxDestroyRESP(reply);
-    reply = redisxArrayRequest(redis, cmd, NULL, args, &status);
-    if(status < 0) break;
-
-    // We expect an array of 2 elements { cursor, { key , value ... } }
-    status = redisxCheckRESP(reply, RESP_ARRAY, 2);
-    if(status < 0) break;
-
-    components = (RESP **) reply->value;
+    RESP **components = rScanNextPage(&scan, &count);
 
-    status = redisxCheckRESP(components[0], RESP_BULK_STRING, 0);
-    if(status < 0) break;
-
-    status = redisxCheckRESP(components[1], RESP_ARRAY, 0);
-    if(status < 0) break;
-
-    // Discard previously received cursor...
-    free(*pCursor);
-    *pCursor = (char *) components[0]->value;
-    components[0]->value = NULL;        // de-reference name from RESP.
+    if(count < 0) {
+      status = count;
+      break;
+    }
 
-    count = components[1]->n >> 1;
-    components = (RESP **) components[1]->value;
+    count >>= 1;
 
     // OK, we got a reasonable response, now make sure we have storage space for it.
     if(!entries) {
+      while(count > capacity) capacity <<= 1;
       entries = (RedisEntry *) calloc(capacity, sizeof(RedisEntry));
       if(!entries) {
         fprintf(stderr, "WARNING! Redis-X : alloc up to %d table entries: %s\n", capacity, strerror(errno));
@@ -849,7 +1266,7 @@ RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern
     else if(*n + count > capacity) {
       RedisEntry *old = entries;
 
-      capacity <<= 1;
+      while(*n + count > capacity) capacity <<= 1;
       entries = (RedisEntry *) realloc(entries, capacity * sizeof(RedisEntry));
       if(!entries) {
         fprintf(stderr, "WARNING! Redis-X : realloc up to %d table entries: %s\n", capacity, strerror(errno));
@@ -880,11 +1297,10 @@ RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern
       components[k+1]->value = NULL;        // de-reference value from RESP.
     }
 
-  } while(strcmp(*pCursor, SCAN_INITIAL_CURSOR));  // Done when cursor is back to 0...
+  } while(!status && !scan.done);
 
   // Clean up.
-  redisxDestroyRESP(reply);
-  free(*pCursor);
+  rScanDestroy(&scan);
 
   // Check for errors
   if(status < 0) {
@@ -918,6 +1334,166 @@ RedisEntry *redisxScanTable(Redis *redis, const char *table, const char *pattern
   return entries;
 }
 
+
+/**
+ * Starts iterating over the entries of a Redis hash table, page by page, using the Redis HSCAN command. Unlike
+ * redisxScanTable(), it does not collect the entire table in memory before returning, and so it is better
+ * suited for processing large tables. The entries are returned in the order they are scanned, not sorted.
+ *
+ * HSCAN may return the same field more than once. If required, the iterator can remove duplicates for you,
+ * by keeping a copy of every field returned so far in a hash set. The set is released only when the iterator
+ * is closed, and it costs a copy of each distinct field plus about 50 to 100 bytes of table space per field.
+ * When iterating over very large tables with little memory to spare, you may prefer to deal with the
+ * occasional duplicate yourself.
+ *
+ * The caller may adjust the amount of work performed in each scan call via the redisxSetScanCount()
+ * function, prior to calling this.
+ *
+ * \param redis     Pointer to a Redis instance.
+ * \param table     Name of Redis hash table to scan data from
+ * \param pattern   keyword pattern to match, or NULL for all keys.
+ * \param dedupe    Whether to remove duplicate fields from the results.
+ * \return          A new iterator, or else NULL if there was an error (errno will indicate the type of error).
+ *
+ * @sa redisxTableIteratorNext()
+ * @sa redisxTableIteratorClose()
+ * @sa redisxScanTable()
+ */
+RedisTableIterator *redisxTableIteratorOpen(Redis *redis, const char *table, const char *pattern, boolean dedupe) {
+  static const char *fn = "redisxTableIteratorOpen";
+
+  RedisTableIterator *it;
+  TableIterator *p;
+
+  if(redisxCheckValid(redis) != X_SUCCESS) return x_trace_null(fn, NULL);
+
+  if(table == NULL) {
+    x_error(0, EINVAL, fn, "'table' parameter is NULL");
+    return NULL;
+  }
+
+  if(!table[0]) {
+    x_error(0, EINVAL, fn, "'table' parameter is empty");
+    return NULL;
+  }
+
+  it = (RedisTableIterator *) calloc(1, sizeof(RedisTableIterator));
+  x_check_alloc(it);
+
+  p = (TableIterator *) calloc(1, sizeof(TableIterator));
+  x_check_alloc(p);
+
+  it->priv = p;
+
+  if(rScanInit(&p->scan, redis, "HSCAN", table, pattern, FALSE) != X_SUCCESS) {
+    free(p);
+    free(it);
+    return x_trace_null(fn, NULL);
+  }
+
+  if(dedupe) {
+    p->seen = (RedisHashSet *) calloc(1, sizeof(RedisHashSet));
+    x_check_alloc(p->seen);
+  }
+
+  return it;
+}
+
+/**
+ * Returns the next batch of entries from a table iterator, as they arrive from Redis. The returned entries, with
+ * their keys and values, remain valid only until the next call, or until the iterator is closed, and must not be
+ * modified or freed by the caller.
+ *
+ * \param it        Pointer to a table iterator
+ * \param[out] n    Pointer to the integer in which the number of entries (&gt;=0) returned is stored, or else an
+ *                  error code (&lt;0).
+ * \return          The next batch of entries, or NULL if there are no more entries, or if there was an error.
+ *
+ * @sa redisxTableIteratorOpen()
+ * @sa redisxTableIteratorClose()
+ */
+const RedisEntry *redisxTableIteratorNext(RedisTableIterator *it, int *n) {
+  static const char *fn = "redisxTableIteratorNext";
+
+  TableIterator *p;
+
+  if(n == NULL) {
+    x_error(0, EINVAL, fn, "parameter 'n' is NULL");
+    return NULL;
+  }
+
+  *n = 0;
+
+  if(!it) {
+    *n = x_error(X_NULL, EINVAL, fn, "iterator is NULL");
+    return NULL;
+  }
+
+  p = (TableIterator *) it->priv;
+
+  // Skip empty pages (after removing duplicates) until done...
+  while(*n == 0 && !p->scan.done) {
+    RESP **components;
+    int i, count;
+
+    components = rScanNextPage(&p->scan, &count);
+    if(count < 0) {
+      *n = count;
+      return x_trace_null(fn, NULL);
+    }
+
+    count >>= 1;
+
+    if(count > p->capacity) {
+      p->capacity = count;
+      p->entries = (RedisEntry *) realloc(p->entries, count * sizeof(RedisEntry));
+      x_check_alloc(p->entries);
+    }
+
+    for(i = 0; i < count; i++) {
+      const RESP *key = components[i << 1];
+      const RESP *value = components[(i << 1) + 1];
+      RedisEntry *e = &p->entries[*n];
+
+      if(redisxCheckRESP(key, RESP_BULK_STRING, 0) != X_SUCCESS) continue;
+      if(redisxCheckRESP(value, RESP_BULK_STRING, 0) != X_SUCCESS) continue;
+
+      if(p->seen && !rHashSetAdd(p->seen, (char *) key->value, key->n)) continue;
+
+      e->key = (char *) key->value;
+      e->value = (char *) value->value;
+      e->length = value->n;
+
+      (*n)++;
+    }
+  }
+
+  return *n > 0 ? p->entries : NULL;
+}
+
+/**
+ * Closes a table iterator, and frees up all resources used by it.
+ *
+ * \param it        Pointer to a table iterator. It may be NULL, in which case this call does nothing.
+ *
+ * @sa redisxTableIteratorOpen()
+ */
+void redisxTableIteratorClose(RedisTableIterator *it) {
+  TableIterator *p;
+
+  if(!it) return;
+
+  p = (TableIterator *) it->priv;
+  if(p) {
+    rScanDestroy(&p->scan);
+    rHashSetDestroy(p->seen);
+    free(p->entries);
+    free(p);
+  }
+
+  free(it);
+}
+
 /**
  * Destroy a RedisEntry array with dynamically allocate keys/values, such as returned e.g. by
  * redisxScanTable().
@@ -966,11 +1542,95 @@ void redisxDestroyKeys(char **keys, int count) {
   free(keys);
 }
 
+/// \cond PRIVATE
+
+/**
+ * Sends requests to delete a set of keys or hash fields, in batches of up to DELETE_BATCH_SIZE per request,
+ * without waiting for the replies.
+ *
+ * @param cl          A locked interactive client
+ * @param command     The delete command, e.g. "UNLINK" or "HDEL"
+ * @param table       The hash table for deleting fields, or NULL when deleting keys.
+ * @param names       The keys or fields to delete
+ * @param n           The number of keys or fields
+ * @param[out] sent   Pointer to the integer in which to return the number of requests that were sent, even
+ *                    if sending the rest failed.
+ * @return            X_SUCCESS (0) if all requests were sent, or else an error code &lt;0.
+ */
+static int rSendDeletesAsync(RedisClient *cl, const char *command, const char *table, char **names, int n, int *sent) {
+  const char *args[DELETE_BATCH_SIZE + 2];
+  const int end = DELETE_BATCH_SIZE + (table ? 2 : 1);   // command, table (if any), and up to DELETE_BATCH_SIZE names
+  int i;
+
+  *sent = 0;
+
+  for(i = 0; i < n; ) {
+    int k = 0;
+
+    args[k++] = command;
+    if(table) args[k++] = table;
+    while(i < n && k < end) args[k++] = names[i++];
+
+    prop_error("rSendDeletesAsync", redisxSendArrayRequestAsync(cl, args, NULL, k));
+    (*sent)++;
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Deletes a set of keys or hash fields, with the batched delete requests pipelined on an interactive client,
+ * in a single round trip.
+ *
+ * @param redis       Pointer to the Redis instance.
+ * @param command     The delete command, e.g. "UNLINK" or "HDEL"
+ * @param table       The hash table for deleting fields, or NULL when deleting keys.
+ * @param names       The keys or fields to delete
+ * @param n           The number of keys or fields
+ * @return            The number of keys or fields deleted (&gt;=0), or else an error code &lt;0.
+ */
+static int rDeleteBatched(Redis *redis, const char *command, const char *table, char **names, int n) {
+  static const char *fn = "rDeleteBatched";
+
+  RedisClient *cl;
+  int sent, deleted = 0, status = X_SUCCESS;
+
+  if(n < 1) return 0;
+
+  cl = rLockInteractive(redis, &status);
+  if(!cl) return x_trace(fn, NULL, status);
+
+  status = rSendDeletesAsync(cl, command, table, names, n, &sent);
+
+  // Collect the replies to all requests that were sent, even if sending the rest failed.
+  while(--sent >= 0) {
+    int s = X_SUCCESS;
+    RESP *reply = redisxReadReplyAsync(cl, &s);
+
+    if(!s) s = redisxCheckRESP(reply, RESP_INT, 0);
+    if(!s) deleted += reply->n;
+    else if(!status) status = s;
+
+    redisxDestroyRESP(reply);
+  }
+
+  redisxUnlockClient(cl);
+
+  prop_error(fn, status);
+  return deleted;
+}
+
+/// \endcond
+
 // The following is not available prior to the POSIX.1-2001 standard
 #if FNMATCH || _POSIX_C_SOURCE >= 200112L
 
 /**
- * Removes all Redis entries that match the specified table:field name pattern.
+ * Removes all Redis entries that match the specified table:field name pattern. Tables whose name matches the
+ * pattern are removed in their entirety, while for other tables matching the table part of the pattern, only
+ * the fields matching the pattern are removed. The deletes are batched into multi-key `UNLINK` and multi-field
+ * `HDEL` requests, which are pipelined, so that each table takes only one round trip to purge after it was
+ * scanned.
  *
  * NOTES:
  * <ol>
@@ -985,13 +1645,15 @@ void redisxDestroyKeys(char **keys, int count) {
  * \param pattern   Glob pattern of aggregate table:field IDs to delete
  * \return          The number of tables + fields that were matched and deleted, or
  *                  else an xchange error code (&lt;0).
+ *
+ * @sa redisxDeleteEntriesOnServer()
  */
 int redisxDeleteEntries(Redis *redis, const char *pattern) {
   static const char *fn = "redisxDeleteEntries";
 
   char *root, *key;
-  char **keys;
-  int i, n = 0, found = 0, status;
+  char **keys, **tables;
+  int i, k, n = 0, nTables = 0, found = 0;
 
   if(!pattern) return x_error(X_NULL, EINVAL, fn, "'pattern' is NULL");
   if(!pattern[0]) return x_error(X_NULL, EINVAL, fn, "'pattern' is empty");
@@ -1014,49 +1676,145 @@ int redisxDeleteEntries(Redis *redis, const char *pattern) {
     n = 1;
   }
 
+  // Tables to delete wholesale
+  tables = (char **) calloc(n > 0 ? n : 1, sizeof(char *));
+  x_check_alloc(tables);
+
   for(i = 0; i < n ; i++) {
-    const char *table = keys[i];
+    char *table = keys[i];
     RedisEntry *entries;
-    int nEntries;
+    char **fields;
+    int nEntries, nFields = 0;
 
-    // If the table itself matches, delete it wholesale...
-    if(fnmatch(root, table, 0) == 0) {
-      RESP *reply = redisxRequest(redis, "DEL", table, NULL, NULL, &status);
-      if(status == X_SUCCESS) if(redisxCheckRESP(reply, RESP_INT, 1) == X_SUCCESS) found++;
-      redisxDestroyRESP(reply);
+    // If the table itself matches, delete it wholesale (along with the others)...
+    if(fnmatch(pattern, table, 0) == 0) {
+      tables[nTables++] = table;
       continue;
     }
 
     // Otherwise check the table entries...
     entries = redisxScanTable(redis, table, key, &nEntries);
-    if(nEntries > 0) {
-      int k;
-      for(k = 0; k < nEntries; k++) {
-        const RedisEntry *e = &entries[k];
-        char *id = xGetAggregateID(table, e->key);
-
-        if(id) {
-          if(fnmatch(key, id, 0) == 0) {
-            RESP *reply = redisxRequest(redis, "HDEL", table, e->key, NULL, &status);
-            if(status == X_SUCCESS) if(redisxCheckRESP(reply, RESP_INT, 1) == X_SUCCESS) found++;
-            redisxDestroyRESP(reply);
-          }
-          free(id);
-        }
-
-        if(e->key) free(e->key);
-        if(e->value) free(e->value);
+    if(nEntries <= 0) continue;
+
+    fields = (char **) calloc(nEntries, sizeof(char *));
+    x_check_alloc(fields);
+
+    for(k = 0; k < nEntries; k++) {
+      const RedisEntry *e = &entries[k];
+      char *id = xGetAggregateID(table, e->key);
+
+      if(id) {
+        if(fnmatch(pattern, id, 0) == 0) fields[nFields++] = e->key;
+        free(id);
       }
     }
 
-    if(entries) free(entries);
+    k = rDeleteBatched(redis, "HDEL", table, fields, nFields);
+    if(k > 0) found += k;
+
+    free(fields);
+    redisxDestroyEntries(entries, nEntries);
   }
 
+  k = rDeleteBatched(redis, "UNLINK", NULL, tables, nTables);
+  if(k > 0) found += k;
+
+  free(tables);
   redisxDestroyKeys(keys, n);
   free(root);
 
-
   return found;
 }
 
 #endif
+
+/// \cond PRIVATE
+
+/**
+ * Lua script for deleting entries matching a table:field pattern on the server. ARGV[1] is the full pattern,
+ * to match tables to remove wholesale; ARGV[2] is the table part of the pattern, and ARGV[3] (if present) is the
+ * field part of the pattern, to match the fields to remove from other tables.
+ */
+static const char *rDeleteScript =
+        "local n = 0\n"
+        "local cursor = '0'\n"
+        "repeat\n"
+        "  local page = redis.call('SCAN', cursor, 'MATCH', ARGV[1], 'COUNT', 1000)\n"
+        "  cursor = page[1]\n"
+        "  if #page[2] > 0 then n = n + redis.call('UNLINK', unpack(page[2])) end\n"
+        "until cursor == '0'\n"
+        "if ARGV[3] then\n"
+        "  repeat\n"
+        "    local page = redis.call('SCAN', cursor, 'MATCH', ARGV[2], 'TYPE', 'hash', 'COUNT', 1000)\n"
+        "    cursor = page[1]\n"
+        "    for _, t in ipairs(page[2]) do\n"
+        "      local c = '0'\n"
+        "      repeat\n"
+        "        local r = redis.call('HSCAN', t, c, 'MATCH', ARGV[3], 'COUNT', 1000)\n"
+        "        local fields = {}\n"
+        "        c = r[1]\n"
+        "        for i = 1, #r[2], 2 do fields[#fields + 1] = r[2][i] end\n"
+        "        if #fields > 0 then n = n + redis.call('HDEL', t, unpack(fields)) end\n"
+        "      until c == '0'\n"
+        "    end\n"
+        "  until cursor == '0'\n"
+        "end\n"
+        "return n\n";
+
+/// \endcond
+
+/**
+ * Removes all Redis entries that match the specified table:field name pattern, like redisxDeleteEntries(), but
+ * entirely on the server side, by a Lua script, in a single round trip. The tables and fields are matched by the
+ * globbing of the Redis `SCAN` and `HSCAN` commands, rather than by `fnmatch()`, so this function is available
+ * also on platforms without the latter.
+ *
+ * NOTES:
+ * <ol>
+ * <li>The server will not process other requests until the script completes, which may take a while if a
+ * large number of keys are scanned. Use redisxDeleteEntries() instead if that is not acceptable.</li>
+ * <li>The script accesses keys that are not declared to Redis, and hence it cannot be used on Redis
+ * clusters.</li>
+ * <li>It requires Redis 6.0 or later, or Valkey.</li>
+ * </ol>
+ *
+ * \param redis     Pointer to the Redis instance.
+ * \param pattern   Glob pattern of aggregate table:field IDs to delete
+ * \return          The number of tables + fields that were matched and deleted, or
+ *                  else an xchange error code (&lt;0).
+ *
+ * @sa redisxDeleteEntries()
+ */
+int redisxDeleteEntriesOnServer(Redis *redis, const char *pattern) {
+  static const char *fn = "redisxDeleteEntriesOnServer";
+
+  const char *args[6];
+  char *root, *key = NULL;
+  RESP *reply;
+  int n = 0, status = X_SUCCESS;
+
+  if(!pattern) return x_error(X_NULL, EINVAL, fn, "'pattern' is NULL");
+  if(!pattern[0]) return x_error(X_NULL, EINVAL, fn, "'pattern' is empty");
+
+  // Separate the top-level component
+  root = xStringCopyOf(pattern);
+  xSplitID(root, &key);
+
+  args[n++] = "EVAL";
+  args[n++] = rDeleteScript;
+  args[n++] = "0";
+  args[n++] = pattern;
+  args[n++] = root;
+  if(key) args[n++] = key;
+
+  reply = redisxArrayRequest(redis, args, NULL, n, &status);
+  free(root);
+
+  if(!status) status = redisxCheckRESP(reply, RESP_INT, 0);
+  if(!status) n = reply->n;
+
+  redisxDestroyRESP(reply);
+
+  prop_error(fn, status);
+  return n;
+}
@@ -245,11 +245,15 @@ enum redisx_protocol redisxGetProtocol(Redis *redis) {
  * @sa redisxSetSocketTimeout()
  */
 int redisxSetReplyTimeout(Redis *redis, int timeoutMillis) {
+  const RedisPrivate *p;
   ClientPrivate *cp;
+  int i;
 
   prop_error("redisxSetTcpBuf", rConfigLock(redis));
+  p = (RedisPrivate *) redis->priv;
   cp = (ClientPrivate *) redis->interactive->priv;
   cp->timeoutMillis = timeoutMillis > 0 ? timeoutMillis : -1;
+  for(i = 0; i < p->poolSize; i++) ((ClientPrivate *) p->pool[i].priv)->timeoutMillis = cp->timeoutMillis;
   rConfigUnlock(redis);
 
   return X_SUCCESS;
@@ -422,7 +426,11 @@ static int redisxSelectDBAsync(RedisClient *cl, int idx, boolean confirm) {
 
   if(confirm) {
     int status = X_SUCCESS;
-    RESP *reply = redisxReadReplyAsync(cl, &status);
+    RESP *reply;
+
+    prop_error(fn, redisxFlushAsync(cl));
+
+    reply = redisxReadReplyAsync(cl, &status);
 
     prop_error(fn, status);
 
@@ -436,9 +444,26 @@ static int redisxSelectDBAsync(RedisClient *cl, int idx, boolean confirm) {
   return X_SUCCESS;
 }
 
-static void rAffirmDB(Redis *redis) {
-  const RedisPrivate *p = (RedisPrivate *) redis->priv;
-  redisxSelectDB(redis, p->config.dbIndex);
+/**
+ * Switches a client to another database, if it is connected. Clients that are not connected will switch
+ * to the configured database when they connect.
+ *
+ * @param cl          the redis client
+ * @param idx         zero-based database index
+ * @param confirm     Whether to wait for confirmation from Redis, and check the response.
+ * @return            X_SUCCESS (0) if successful, or else an error code (&lt;0) from redisx.h / xchange.h.
+ */
+static int rSwitchClientDB(RedisClient *cl, int idx, boolean confirm) {
+  int status;
+
+  if(redisxLockClient(cl) != X_SUCCESS) return X_SUCCESS;
+
+  if(!((ClientPrivate *) cl->priv)->isEnabled) status = X_SUCCESS;
+  else status = redisxSelectDBAsync(cl, idx, confirm);
+
+  redisxUnlockClient(cl);
+
+  return status;
 }
 
 /**
@@ -446,6 +471,9 @@ static void rAffirmDB(Redis *redis) {
  * PUB/SUB channel, hence the call will return X_INCOMPLETE if attempted. You should instead switch DB when there
  * are no active subscriptions.
  *
+ * The database index is also applied to every client (including pooled interactive clients) that connects or
+ * reconnects afterwards.
+ *
  * @param redis       Pointer to a Redis instance.
  * @param idx         zero-based database index
  * @return            X_SUCCESS (0) if successful, or
@@ -460,43 +488,33 @@ static void rAffirmDB(Redis *redis) {
 int redisxSelectDB(Redis *redis, int idx) {
   static const char *fn = "redisxSelectDB";
 
-  const RedisPrivate *p;
-  enum redisx_channel c;
-  int dbIdx, status = X_SUCCESS;
+  RedisPrivate *p;
+  RedisClient *pool;
+  int i, dbIdx, poolSize, status = X_SUCCESS;
 
   prop_error(fn, rConfigLock(redis));
   p = (RedisPrivate *) redis->priv;
   dbIdx = p->config.dbIndex;
+  p->config.dbIndex = idx;          // Clients (re)connecting from now on will use it.
+  pool = p->pool;
+  poolSize = p->poolSize;
   rConfigUnlock(redis);
 
   if(dbIdx == idx) return X_SUCCESS;
 
-  if(idx) redisxAddConnectHook(redis, rAffirmDB);   // Use SELECT to switch to non-zero DB
-  else redisxRemoveConnectHook(redis, rAffirmDB);   // Don't use SELECT for DB 0 (cluster safe)
-
   if(!redisxIsConnected(redis)) return X_SUCCESS;
 
-  for(c = 0; c < REDISX_CHANNELS; c++) {
-    RedisClient *cl = redisxGetClient(redis, c);
-    int s = redisxLockConnected(cl);
+  // We can't switch the existing subscription client
+  if(((ClientPrivate *) redis->subscription->priv)->isEnabled) status = X_INCOMPLETE;
 
-    // We can't switch unconnected clients or the existing subscription client
-    if(s == REDIS_INVALID_CHANNEL || c == REDISX_SUBSCRIPTION_CHANNEL) {
-      if(!s) status = X_INCOMPLETE;
-      redisxUnlockClient(cl);
-      continue;
-    }
-
-    s = redisxSelectDBAsync(cl, idx, c != REDISX_PIPELINE_CHANNEL);
-    redisxUnlockClient(cl);
-
-    if(s) {
-      char str[20];
-      sprintf(str, "%d", idx);
+  if(rSwitchClientDB(redis->interactive, idx, TRUE) != X_SUCCESS) status = X_INCOMPLETE;
+  if(rSwitchClientDB(redis->pipeline, idx, FALSE) != X_SUCCESS) status = X_INCOMPLETE;
+  for(i = 0; i < poolSize; i++) if(rSwitchClientDB(&pool[i], idx, TRUE) != X_SUCCESS) status = X_INCOMPLETE;
 
-      status = X_INCOMPLETE;
-      x_trace(fn, str, status);
-    }
+  if(status) {
+    char str[20];
+    sprintf(str, "%d", idx);
+    x_trace(fn, str, status);
   }
 
   return status;
@@ -731,9 +749,8 @@ RESP *redisxArrayRequest(Redis *redis, const char **args, const int *lengths, in
     return x_trace_null(fn, NULL);
   }
 
-  cl = redis->interactive;
-  s = redisxLockConnected(cl);
-  if(s) {
+  cl = rLockInteractive(redis, &s);
+  if(!cl) {
     if(status) *status = s;
     return x_trace_null(fn, NULL);
   }
@@ -54,6 +54,117 @@ void redisxDestroyRESP(RESP *resp) {
   free(resp);
 }
 
+/// \cond PRIVATE
+
+#ifndef REDISX_ARENA_BLOCK_SIZE
+/// (bytes) Initial storage size of arena blocks. Subsequent blocks are progressively larger.
+#  define REDISX_ARENA_BLOCK_SIZE       4096
+#endif
+
+#ifndef REDISX_ARENA_MAX_BLOCK_SIZE
+/// (bytes) The maximum storage size of arena blocks, except for single allocations that exceed it.
+#  define REDISX_ARENA_MAX_BLOCK_SIZE   (1024 * 1024)
+#endif
+
+#define ARENA_ALIGN   (sizeof(double) > sizeof(void *) ? sizeof(double) : sizeof(void *))
+
+static ArenaBlock *rNewArenaBlock(size_t size) {
+  ArenaBlock *b = (ArenaBlock *) malloc(ARENA_HEADER_SIZE + size);
+  if(!b) return NULL;
+
+  b->next = NULL;
+  b->size = size;
+  b->used = 0;
+  return b;
+}
+
+/**
+ * Allocates storage from an arena. The storage is aligned for any type, and it is freed only
+ * together with the rest of the arena. The first allocation from a new arena is always at the
+ * start of the first block's storage.
+ *
+ * @param arena     The arena from which to allocate.
+ * @param size      (bytes) The amount of storage needed
+ * @return          The allocated (uninitialized) storage, or NULL if there was an allocation error.
+ *
+ * @sa rArenaFree()
+ */
+void *rArenaAlloc(RedisArena *arena, size_t size) {
+  ArenaBlock *b = arena->last;
+  char *ptr;
+
+  size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+  if(!b) {
+    b = rNewArenaBlock(size > REDISX_ARENA_BLOCK_SIZE ? size : REDISX_ARENA_BLOCK_SIZE);
+    if(!b) return NULL;
+    arena->first = arena->last = b;
+  }
+  else if(b->used + size > b->size) {
+    size_t next = b->size < REDISX_ARENA_MAX_BLOCK_SIZE ? 2 * b->size : b->size;
+
+    if(size > next) {
+      // Oversized allocation in a dedicated block, linked after the first...
+      b = rNewArenaBlock(size);
+      if(!b) return NULL;
+      b->used = size;
+      b->next = arena->first->next;
+      arena->first->next = b;
+      return (char *) b + ARENA_HEADER_SIZE;
+    }
+
+    b = rNewArenaBlock(next);
+    if(!b) return NULL;
+    b->next = arena->last->next;
+    arena->last->next = b;
+    arena->last = b;
+  }
+
+  ptr = (char *) b + ARENA_HEADER_SIZE + b->used;
+  b->used += size;
+  return ptr;
+}
+
+/**
+ * Frees all storage that was allocated from an arena, and resets it for reuse.
+ *
+ * @param arena     The arena
+ *
+ * @sa rArenaAlloc()
+ */
+void rArenaFree(RedisArena *arena) {
+  ArenaBlock *b = arena->first;
+
+  while(b) {
+    ArenaBlock *next = b->next;
+    free(b);
+    b = next;
+  }
+
+  arena->first = arena->last = NULL;
+}
+
+/// \endcond
+
+/**
+ * Frees up all resources used by a RESP that was returned by redisxReadArenaReplyAsync(), in a single step.
+ * You must not call redisxDestroyRESP() on arena replies, or on any of their components, and you must not
+ * free() or reassign any of their components or values, since these do not have their own heap allocation.
+ * The call will segfault if the same RESP is destroyed twice, or if the argument is not an arena reply.
+ *
+ * \param resp      Pointer to the arena RESP structure to be destroyed, which may be NULL (no action taken).
+ *
+ * @sa redisxReadArenaReplyAsync()
+ */
+void redisxDestroyArenaRESP(RESP *resp) {
+  RedisArena arena = {};
+
+  if(resp == NULL) return;
+
+  arena.first = (ArenaBlock *) ((char *) resp - ARENA_HEADER_SIZE);
+  rArenaFree(&arena);
+}
+
 /**
  * Creates an independent deep copy of the RESP, which shares no references with the original.
  *
@@ -389,6 +500,25 @@ boolean redisxHasComponents(const RESP *r) {
  *                        error.
  */
 int redisxAppendRESP(RESP *resp, RESP *part) {
+  prop_error("redisxAppendRESP", rAppendRESP(NULL, resp, part));
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+
+/**
+ * Same as redisxAppendRESP(), but for RESP data, which have been allocated from an arena, or else from
+ * the heap if the arena is NULL.
+ *
+ * @param arena           The arena from which the RESP and its components were allocated, or NULL
+ *                        if they were allocated on the heap.
+ * @param resp            The RESP to which the part is appended
+ * @param part            The part, which is destroyed after the content is appended to the first RESP argument.
+ * @return                X_SUCCESS (0) if successful, or else an error code &lt;0, as for redisxAppendRESP().
+ *
+ * @sa redisxAppendRESP()
+ */
+int rAppendRESP(RedisArena *arena, RESP *resp, RESP *part) {
   static const char *fn = "redisxAppendRESP";
   char *old, *extend;
   size_t eSize;
@@ -399,7 +529,7 @@ int redisxAppendRESP(RESP *resp, RESP *part) {
     return 0;
   if(resp->type != part->type) {
     int err = x_error(REDIS_UNEXPECTED_RESP, EINVAL, fn, "Mismatched types: '%c' vs. '%c'", resp->type, part->type);
-    redisxDestroyRESP(part);
+    if(!arena) redisxDestroyRESP(part);
     return err;
   }
   if(redisxIsScalarType(resp))
@@ -413,20 +543,34 @@ int redisxAppendRESP(RESP *resp, RESP *part) {
     eSize = 1;
 
   old = resp->value;
-  extend = (char *) realloc(resp->value, (resp->n + part->n) * eSize);
-  if(!extend) {
-    free(old);
-    return x_error(X_FAILURE, errno, fn, "alloc RESP array (%d components)", resp->n + part->n);
+
+  if(arena) {
+    // The old storage is simply abandoned in the arena.
+    extend = (char *) rArenaAlloc(arena, (resp->n + part->n) * eSize);
+    if(!extend) return x_error(X_FAILURE, errno, fn, "alloc RESP array (%d components)", resp->n + part->n);
+    if(old) memcpy(extend, old, resp->n * eSize);
+  }
+  else {
+    extend = (char *) realloc(resp->value, (resp->n + part->n) * eSize);
+    if(!extend) {
+      free(old);
+      return x_error(X_FAILURE, errno, fn, "alloc RESP array (%d components)", resp->n + part->n);
+    }
   }
 
   memcpy(extend + resp->n * eSize, part->value, part->n * eSize);
   resp->n += part->n;
   resp->value = extend;
-  free(part);
+  if(!arena) {
+    free(part->value);
+    free(part);
+  }
 
   return X_SUCCESS;
 }
 
+/// \endcond
+
 /**
  * Checks if two RESP are equal, that is they hold the same type of data, have the same 'n' value,
  * and the values match byte-for-byte, or are both NULL.
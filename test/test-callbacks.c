@@ -0,0 +1,158 @@
+/**
+ * @file
+ *
+ * Offline test of per-request pipeline callbacks, via a local socket pair in place of a server connection.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include "test-fixture.h"
+
+#define N_REQUESTS    20
+
+static int nCalls, nConsumed;
+static long values[N_REQUESTS];
+
+static void callback(RESP *reply, void *arg) {
+  int i = (int) (long) arg;
+
+  if(i >= 0 && i < N_REQUESTS) values[i] = (reply && reply->type == RESP_INT) ? reply->n : -1;
+  nCalls++;
+}
+
+static void consume(RESP *reply) {
+  (void) reply;
+  nConsumed++;
+}
+
+static int sendCb(Redis *redis, int i) {
+  const char *args[] = { "ECHO", "x" };
+  return redisxSendRequestCb(redis, args, NULL, 2, callback, (void *) (long) i);
+}
+
+static int sendPlain(RedisClient *cl, boolean skip) {
+  int status;
+
+  redisxLockClient(cl);
+  if(skip) redisxSkipReplyAsync(cl);
+  status = redisxSendRequestAsync(cl, "PING", NULL, NULL, NULL);
+  redisxUnlockClient(cl);
+
+  return status;
+}
+
+// Reads and processes all replies available, like the pipeline listener would.
+static void processReplies(Redis *redis, int n) {
+  while(--n >= 0) {
+    RESP *reply = redisxReadReplyAsync(redis->pipeline, NULL);
+    if(!reply) break;
+    rProcessPipelineReply(redis, reply);
+    redisxDestroyRESP(reply);
+  }
+}
+
+static int checkValues(const char *what, int n) {
+  int i;
+
+  if(nCalls != n) {
+    fprintf(stderr, "ERROR! %s: %d callbacks, expected %d\n", what, nCalls, n);
+    return -1;
+  }
+
+  for(i = 0; i < n; i++) if(values[i] != i + 1) {
+    fprintf(stderr, "ERROR! %s: callback #%d got %ld\n", what, i, values[i]);
+    return -1;
+  }
+
+  return 0;
+}
+
+static void reset() {
+  memset(values, 0, sizeof(values));
+  nCalls = nConsumed = 0;
+}
+
+static int testOrdering(Redis *redis, int peer) {
+  char buf[100];
+  int i, L = 0;
+
+  reset();
+
+  // Callbacks interleaved with plain requests, some of whose replies are skipped.
+  for(i = 0; i < N_REQUESTS; i++) {
+    if(sendCb(redis, i) != X_SUCCESS) return -1;
+    if(i % 3 == 0 && sendPlain(redis->pipeline, FALSE) != X_SUCCESS) return -1;
+    if(i % 4 == 0 && sendPlain(redis->pipeline, TRUE) != X_SUCCESS) return -1;
+  }
+
+  for(i = 0; i < N_REQUESTS; i++) {
+    L = sprintf(buf, ":%d\r\n", i + 1);
+    if(i % 3 == 0) L += sprintf(buf + L, "$4\r\nPONG\r\n");
+    if(respond(peer, buf) != 0) return -1;
+  }
+
+  processReplies(redis, N_REQUESTS + (N_REQUESTS + 2) / 3);
+
+  if(checkValues("ordering", N_REQUESTS) != 0) return -1;
+
+  if(nConsumed != (N_REQUESTS + 2) / 3) {
+    fprintf(stderr, "ERROR! ordering: consumer got %d replies, expected %d\n", nConsumed, (N_REQUESTS + 2) / 3);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int testBlock(Redis *redis, int peer) {
+  static const char replies[] = "+OK\r\n+QUEUED\r\n*1\r\n+OK\r\n";
+  RedisClient *cl = redis->pipeline;
+  RESP *reply;
+  int i;
+
+  reset();
+
+  // The replies to the transaction, up to EXEC, are read by redisxExecBlockAsync() itself.
+  if(respond(peer, replies) != 0) return -1;
+
+  redisxLockClient(cl);
+  redisxStartBlockAsync(cl);
+  redisxSendRequestAsync(cl, "SET", "key", "value", NULL);
+  reply = redisxExecBlockAsync(cl, NULL);
+  redisxUnlockClient(cl);
+
+  if(!reply || reply->type != RESP_ARRAY || reply->n != 1) {
+    fprintf(stderr, "ERROR! block: unexpected EXEC reply\n");
+    return -1;
+  }
+  redisxDestroyRESP(reply);
+
+  // Callbacks after the block must see their own replies.
+  for(i = 0; i < 3; i++) if(sendCb(redis, i) != X_SUCCESS) return -1;
+  if(respond(peer, ":1\r\n:2\r\n:3\r\n") != 0) return -1;
+  processReplies(redis, 3);
+
+  return checkValues("block", 3);
+}
+
+int main() {
+  Redis *redis;
+  int peer;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  redisxSetPipelineConsumer(redis, consume);
+
+  peer = openTestClient(redis->pipeline);
+  if(peer < 0) return 1;
+
+  if(testOrdering(redis, peer) != 0) return 1;
+  if(testBlock(redis, peer) != 0) return 1;
+
+  closeTestClient(redis->pipeline, peer);
+
+  printf("OK\n");
+  return 0;
+}
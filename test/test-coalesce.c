@@ -0,0 +1,140 @@
+/**
+ * @file
+ *
+ * Offline test of the flush triggers of write coalescing, via a local socket pair in place of a server
+ * connection.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include "test-fixture.h"
+
+#define PING          "*1\r\n$4\r\nPING\r\n"
+#define PING_SIZE     (sizeof(PING) - 1)
+
+#define BUF_SIZE      (4 * PING_SIZE)     ///< Coalescing buffer that holds exactly 4 PINGs
+#define LONG_DELAY    10000000            ///< [us] Longer than the test
+#define SHORT_DELAY   20000               ///< [us]
+
+static int peer;
+
+// Returns the number of bytes the server side received so far, without waiting.
+static int received() {
+  char buf[1000];
+  int n = (int) recv(peer, buf, sizeof(buf), MSG_DONTWAIT);
+  return n > 0 ? n : 0;
+}
+
+static int ping(RedisClient *cl) {
+  int status;
+
+  redisxLockClient(cl);
+  status = redisxSendRequestAsync(cl, "PING", NULL, NULL, NULL);
+  redisxUnlockClient(cl);
+
+  return status;
+}
+
+static int check(const char *what, int n, int expected) {
+  if(n == expected) return 0;
+  fprintf(stderr, "ERROR! %s: received %d bytes, expected %d\n", what, n, expected);
+  return -1;
+}
+
+int main() {
+  Redis *redis;
+  RedisClient *cl;
+  RESP *reply;
+  char arg[2 * BUF_SIZE];
+  int i, n;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  cl = redis->pipeline;
+  peer = openTestClient(cl);
+  if(peer < 0) return 1;
+
+  if(rSetCoalescing(cl, BUF_SIZE, LONG_DELAY) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! enable coalescing\n");
+    return 1;
+  }
+
+  // Requests wait in the buffer...
+  ping(cl);
+  if(check("buffered", received(), 0) != 0) return 1;
+
+  // ... until flushed explicitly.
+  redisxLockClient(cl);
+  redisxFlushAsync(cl);
+  redisxUnlockClient(cl);
+  if(check("explicit flush", received(), PING_SIZE) != 0) return 1;
+
+  // A full buffer is sent right away.
+  for(i = 0; i < 3; i++) ping(cl);
+  if(check("partly filled", received(), 0) != 0) return 1;
+  ping(cl);
+  if(check("filled", received(), BUF_SIZE) != 0) return 1;
+
+  // Data that does not fit pushes out what is buffered, and then is buffered itself.
+  for(i = 0; i < 3; i++) ping(cl);
+  redisxLockClient(cl);
+  redisxSendRequestAsync(cl, "ECHO", "x", NULL, NULL);
+  redisxUnlockClient(cl);
+  if(check("overflow", received(), 3 * PING_SIZE) != 0) return 1;
+
+  // Requests larger than the buffer are sent directly, in order.
+  memset(arg, 'x', sizeof(arg) - 1);
+  arg[sizeof(arg) - 1] = '\0';
+  redisxLockClient(cl);
+  redisxSendRequestAsync(cl, "ECHO", arg, NULL, NULL);
+  redisxUnlockClient(cl);
+
+  for(n = 0, i = 0; i < 10; i++) n += received();
+  // ECHO x (21 bytes), and ECHO with the long argument (22 bytes + argument)
+  if(check("oversized", n, 21 + 22 + (int) sizeof(arg) - 1) != 0) return 1;
+
+  // With a short delay, the flusher sends buffered requests on its own.
+  if(rSetCoalescing(cl, BUF_SIZE, SHORT_DELAY) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! reconfigure coalescing\n");
+    return 1;
+  }
+
+  ping(cl);
+  if(check("before delay", received(), 0) != 0) return 1;
+  usleep(10 * SHORT_DELAY);
+  if(check("after delay", received(), PING_SIZE) != 0) return 1;
+
+  // Transaction blocks are pushed out before waiting for the reply to EXEC.
+  if(rSetCoalescing(cl, BUF_SIZE, LONG_DELAY) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! reconfigure coalescing\n");
+    return 1;
+  }
+
+  if(respond(peer, "+OK\r\n+QUEUED\r\n*1\r\n+PONG\r\n") != 0) return 1;
+
+  redisxLockClient(cl);
+  redisxStartBlockAsync(cl);
+  redisxSendRequestAsync(cl, "PING", NULL, NULL, NULL);
+  reply = redisxExecBlockAsync(cl, NULL);
+  redisxUnlockClient(cl);
+
+  if(!reply || reply->type != RESP_ARRAY) {
+    fprintf(stderr, "ERROR! block: unexpected EXEC reply\n");
+    return 1;
+  }
+  redisxDestroyRESP(reply);
+
+  // MULTI (15 bytes), PING, and EXEC (14 bytes)
+  if(check("block", received(), 15 + PING_SIZE + 14) != 0) return 1;
+
+  // Disabling coalescing sends what is left in the buffer.
+  ping(cl);
+  rSetCoalescing(cl, 0, 0);
+  if(check("disable", received(), PING_SIZE) != 0) return 1;
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file
+ *
+ * Shared fixture for the offline tests, which attach one end of a local socket pair to a Redis client in
+ * place of a server connection, and play the server on the other end.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+#ifndef TEST_FIXTURE_H_
+#define TEST_FIXTURE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+
+#include "redisx-priv.h"
+
+#define TEST_TIMEOUT_SECONDS  10      ///< Fail, rather than hang, if a test deadlocks or a reply is lost.
+
+#define WAIT_STEP_MICROS      1000    ///< [us] Polling interval when waiting for a background thread.
+#define WAIT_STEPS            2000    ///< Maximum number of polling intervals to wait.
+
+static inline void onTestTimeout(int sig) {
+  (void) sig;
+  fprintf(stderr, "ERROR! timed out (deadlock or lost reply?)\n");
+  exit(1);
+}
+
+/**
+ * Prepares the test process, and returns a new Redis instance for it. Writing to a closed peer does not kill
+ * the process, while a test that does not complete in TEST_TIMEOUT_SECONDS fails.
+ *
+ * @return    A new Redis instance, or NULL if it could not be created.
+ */
+static inline Redis *initTest() {
+  Redis *redis;
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGALRM, onTestTimeout);
+  alarm(TEST_TIMEOUT_SECONDS);
+
+  redis = redisxInit("localhost");
+  if(!redis) fprintf(stderr, "ERROR! init\n");
+
+  return redis;
+}
+
+/**
+ * Connects a client to a local socket, in place of a server.
+ *
+ * @param cl    The Redis client
+ * @return      The peer socket, which plays the server, or -1 if there was an error.
+ */
+static inline int openTestClient(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  int sv[2];
+
+  if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+    perror("ERROR! socketpair");
+    return -1;
+  }
+
+  cp->socket = sv[0];
+  cp->isEnabled = TRUE;
+
+  return sv[1];
+}
+
+/**
+ * Disconnects a client that was connected via openTestClient(), and closes its peer.
+ *
+ * @param cl    The Redis client
+ * @param peer  The peer socket returned by openTestClient().
+ */
+static inline void closeTestClient(RedisClient *cl, int peer) {
+  rCloseClient(cl);
+  close(peer);
+}
+
+/**
+ * Writes data to a client, as if sent by the server.
+ *
+ * @param peer  The peer socket returned by openTestClient().
+ * @param data  The RESP data to send.
+ * @return      0 if successful, or else -1.
+ */
+static inline int respond(int peer, const char *data) {
+  int L = (int) strlen(data);
+  return write(peer, data, L) == L ? 0 : -1;
+}
+
+/**
+ * Waits for a value, which is updated by another thread, to reach the expected value.
+ *
+ * @param value     The value to watch
+ * @param expected  The expected value
+ * @return          0 if the value was reached, or else -1 if it was not reached in time.
+ */
+static inline int waitFor(volatile int *value, int expected) {
+  int i;
+
+  for(i = 0; i < WAIT_STEPS; i++) {
+    if(*value == expected) return 0;
+    usleep(WAIT_STEP_MICROS);
+  }
+
+  return -1;
+}
+
+#endif /* TEST_FIXTURE_H_ */
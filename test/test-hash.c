@@ -16,8 +16,27 @@
 #define TEST_KEY    "123456789"
 #define TEST_HASH   0x31C3
 
+#define N_KEYS      1000
+#define MAX_KEYLEN  100
+
+// Reference CRC-16/XMODEM, one bit at a time
+static uint16_t ref_crc16(const char *buf, size_t len) {
+  uint16_t crc = 0;
+
+  while(len-- > 0) {
+    int i;
+    crc ^= (uint16_t) ((uint8_t) *(buf++)) << 8;
+    for(i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+
+  return crc & (16384 - 1);
+}
+
 int main() {
+  char *keys[N_KEYS];
+  uint16_t slots[N_KEYS];
   uint16_t hash;
+  int i;
 
   hash = rCalcHash(TEST_KEY);
   if(hash != TEST_HASH) {
@@ -31,6 +50,38 @@ int main() {
     return 1;
   }
 
+  // Random keys of all lengths, compared against the reference, one by one and in batch.
+  srand(2025);
+  for(i = 0; i < N_KEYS; i++) {
+    int j, len = i % MAX_KEYLEN;
+
+    keys[i] = (char *) malloc(len + 1);
+    for(j = 0; j < len; j++) keys[i][j] = (char) (1 + rand() % 255);
+    keys[i][len] = '\0';
+
+    // No hashtags in the random keys
+    for(j = 0; j < len; j++) if(keys[i][j] == '{') keys[i][j] = '(';
+
+    hash = rCalcHash(keys[i]);
+    if(hash != ref_crc16(keys[i], len)) {
+      fprintf(stderr, "ERROR! random key %d (len %d): got %hu, expected %hu\n", i, len, hash, ref_crc16(keys[i], len));
+      return 1;
+    }
+  }
+
+  if(redisxClusterHashSlots((const char **) keys, N_KEYS, slots) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! redisxClusterHashSlots() failed\n");
+    return 1;
+  }
+
+  for(i = 0; i < N_KEYS; i++) {
+    if(slots[i] != rCalcHash(keys[i])) {
+      fprintf(stderr, "ERROR! batch key %d: got %hu, expected %hu\n", i, slots[i], rCalcHash(keys[i]));
+      return 1;
+    }
+    free(keys[i]);
+  }
+
   fprintf(stderr, "OK\n");
   return 0;
 }
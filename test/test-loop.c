@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * Offline test of the shared event loop servicing a pipeline client, via a local socket pair.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include "test-fixture.h"
+
+static volatile int nReceived;
+
+static void consume(RESP *reply) {
+  if(reply->type == RESP_INT) nReceived++;
+}
+
+int main() {
+  Redis *redis;
+  RedisPrivate *p;
+  ClientPrivate *cp;
+  int peer;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  p = (RedisPrivate *) redis->priv;
+  cp = (ClientPrivate *) redis->pipeline->priv;
+
+  redisxSetPipelineConsumer(redis, consume);
+  redisxUseEventLoop(redis, TRUE);
+
+  if(redisxStartEventLoop(1) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! start event loop\n");
+    return 1;
+  }
+
+  peer = openTestClient(redis->pipeline);
+  if(peer < 0) return 1;
+
+  p->isPipelineListenerEnabled = TRUE;
+
+  if(rLoopAddClientAsync(redis->pipeline) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! add pipeline client to loop\n");
+    return 1;
+  }
+
+  // Replies are delivered from the loop, including ones that arrive in pieces.
+  if(respond(peer, ":1\r\n:2\r\n:") != 0 || waitFor(&nReceived, 2) != 0) {
+    fprintf(stderr, "ERROR! pipeline replies: got %d, expected 2\n", nReceived);
+    return 1;
+  }
+
+  if(respond(peer, "3\r\n") != 0 || waitFor(&nReceived, 3) != 0) {
+    fprintf(stderr, "ERROR! split pipeline reply: got %d, expected 3\n", nReceived);
+    return 1;
+  }
+
+  // A read error closes the client, which must also mark the listener as disabled, so it is registered
+  // with the loop again on reconnecting.
+  close(peer);
+
+  if(waitFor((volatile int *) &p->isPipelineListenerEnabled, FALSE) != 0) {
+    fprintf(stderr, "ERROR! pipeline listener still enabled after the client was closed\n");
+    return 1;
+  }
+
+  if(cp->isEnabled || cp->socket >= 0) {
+    fprintf(stderr, "ERROR! pipeline client not closed after read error\n");
+    return 1;
+  }
+
+  if(redisxStopEventLoop() != X_SUCCESS) {
+    fprintf(stderr, "ERROR! stop event loop\n");
+    return 1;
+  }
+
+  redisxDestroy(redis);
+
+  printf("OK\n");
+  return 0;
+}
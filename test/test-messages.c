@@ -0,0 +1,112 @@
+/**
+ * @file
+ *
+ * Offline test of delivering PUB/SUB messages to subscribers straight from the receive buffer, via a local
+ * socket pair in place of a server connection.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include "test-fixture.h"
+
+static Redis *redis;
+static int nMessages, nErrors;
+static const char *expected[4];   ///< pattern, channel, message
+static enum { JUST_CHECK, RESIZE, DISCONNECT } action;
+
+static void onMessage(const char *pattern, const char *channel, const char *msg, long length) {
+  int i;
+
+  nMessages++;
+
+  for(i = 0; i < 2; i++) {
+    // Check that the strings stay valid, even if the client moves to a new buffer while we are using them.
+    if(i == 1 && action == RESIZE) redisxSetReceiveBufferSize(redis, REDISX_SUBSCRIPTION_CHANNEL, 4096);
+
+    if((expected[0] ? !pattern || strcmp(pattern, expected[0]) : pattern != NULL) || strcmp(channel, expected[1])
+            || length != (long) strlen(expected[2]) || memcmp(msg, expected[2], length) || msg[length]) {
+      fprintf(stderr, "ERROR! unexpected message on %s: %s\n", channel, msg);
+      nErrors++;
+    }
+  }
+
+  // Callbacks may end the subscription, which closes the client they are called from.
+  if(action == DISCONNECT) redisxEndSubscription(redis);
+}
+
+static int deliver(int peer, const char *data, const char *pattern, const char *channel, const char *msg) {
+  expected[0] = pattern;
+  expected[1] = channel;
+  expected[2] = msg;
+
+  if(data[0] && respond(peer, data) != 0) return -1;
+  return rReadMessageAsync(redis->subscription);
+}
+
+int main() {
+  ClientPrivate *cp;
+  int peer;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  redisxAddSubscriber(redis, NULL, onMessage);
+
+  peer = openTestClient(redis->subscription);
+  if(peer < 0) return 1;
+
+  cp = (ClientPrivate *) redis->subscription->priv;
+
+  // A message, and a pattern message that arrives in two pieces.
+  if(deliver(peer, "*3\r\n$7\r\nmessage\r\n$3\r\nfoo\r\n$5\r\nhello\r\n*4\r\n$8\r\npmessage\r\n$2\r\nb*\r\n$3\r\nbar\r\n$2\r\nhi",
+          NULL, "foo", "hello") != 3) {
+    fprintf(stderr, "ERROR! message not delivered\n");
+    return 1;
+  }
+
+  if(deliver(peer, "\r\n", "b*", "bar", "hi") != 4) {
+    fprintf(stderr, "ERROR! split pmessage not delivered\n");
+    return 1;
+  }
+
+  // The client moves to a new buffer while subscribers use the old one.
+  action = RESIZE;
+  if(deliver(peer, "*3\r\n$8\r\nsmessage\r\n$3\r\nbaz\r\n$4\r\nbulk\r\n*3\r\n$7\r\nmessage\r\n$3\r\nfoo\r\n$4\r\nnext\r\n",
+          NULL, "baz", "bulk") != 3) {
+    fprintf(stderr, "ERROR! message not delivered while resizing\n");
+    return 1;
+  }
+
+  // The remaining data is carried over to the new buffer.
+  action = JUST_CHECK;
+  if(deliver(peer, "", NULL, "foo", "next") != 3) {
+    fprintf(stderr, "ERROR! message not carried over to new buffer\n");
+    return 1;
+  }
+
+  if(cp->inPinned) {
+    fprintf(stderr, "ERROR! buffer remains pinned\n");
+    return 1;
+  }
+
+  // Ending the subscription from a callback must not deadlock.
+  action = DISCONNECT;
+  deliver(peer, "*3\r\n$7\r\nmessage\r\n$3\r\nfoo\r\n$3\r\nbye\r\n", NULL, "foo", "bye");
+
+  if(cp->isEnabled) {
+    fprintf(stderr, "ERROR! subscription client not closed\n");
+    return 1;
+  }
+
+  if(nMessages != 5 || nErrors) {
+    fprintf(stderr, "ERROR! %d messages delivered, with %d errors\n", nMessages, nErrors);
+    return 1;
+  }
+
+  redisxDestroy(redis);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file
+ *
+ * Offline test of turning replies off and back on for a client, via a local socket pair in place of a server
+ * connection. The reply to `CLIENT REPLY ON` must be dropped, without affecting the replies to requests sent
+ * before or after, or in transaction blocks.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include "test-fixture.h"
+
+static RedisClient *cl;
+static ClientPrivate *cp;
+static int peer;
+
+static void request(const char *command, const char *arg) {
+  redisxSendRequestAsync(cl, command, arg, NULL, NULL);
+}
+
+// Sends a few writes with replies turned off.
+static void sendWrites(int n) {
+  int i;
+
+  redisxStartNoReplyAsync(cl);
+  for(i = 0; i < n; i++) redisxSendRequestAsync(cl, "SET", "key", "value", NULL);
+  redisxEndNoReplyAsync(cl);
+}
+
+static int expect(const char *what, const char *value) {
+  RESP *reply = redisxReadReplyAsync(cl, NULL);
+  int status = 0;
+
+  if(!reply || !reply->value || strcmp((char *) reply->value, value) != 0) {
+    fprintf(stderr, "ERROR! %s: got %s, expected %s\n", what, reply && reply->value ? (char *) reply->value : "(null)", value);
+    status = -1;
+  }
+
+  redisxDestroyRESP(reply);
+  return status;
+}
+
+static int checkIdle(const char *what) {
+  if(cp->firstDiscard || cp->pendingRequests) {
+    fprintf(stderr, "ERROR! %s: %d replies pending, discard %s\n", what, cp->pendingRequests, cp->firstDiscard ? "pending" : "done");
+    return -1;
+  }
+  return 0;
+}
+
+static int testBracketing() {
+  // Replies pending from before, and requests made after, replies were off.
+  request("PING", NULL);
+  sendWrites(3);
+  request("GET", "key");
+
+  if(respond(peer, "+PONG\r\n+OK\r\n$5\r\nvalue\r\n") != 0) return -1;
+  if(expect("before", "PONG") != 0) return -1;
+  if(expect("after", "value") != 0) return -1;
+
+  return checkIdle("bracketing");
+}
+
+static int testRepeated() {
+  // Several windows with replies off, before any of the replies are read.
+  request("PING", NULL);
+  sendWrites(2);
+  request("ECHO", "middle");
+  sendWrites(1);
+  sendWrites(1);
+  request("GET", "key");
+
+  if(respond(peer, "+PONG\r\n+OK\r\n$6\r\nmiddle\r\n+OK\r\n+OK\r\n$5\r\nvalue\r\n") != 0) return -1;
+  if(expect("first", "PONG") != 0) return -1;
+  if(expect("middle", "middle") != 0) return -1;
+  if(expect("last", "value") != 0) return -1;
+
+  return checkIdle("repeated");
+}
+
+static int testBlock() {
+  RESP *reply;
+
+  // A transaction block right after replies were turned back on, followed by a plain request.
+  sendWrites(2);
+
+  redisxStartBlockAsync(cl);
+  request("SET", "key");
+  if(respond(peer, "+OK\r\n+OK\r\n+QUEUED\r\n*1\r\n+OK\r\n") != 0) return -1;
+
+  reply = redisxExecBlockAsync(cl, NULL);
+  if(!reply || reply->type != RESP_ARRAY || reply->n != 1) {
+    fprintf(stderr, "ERROR! block: unexpected EXEC reply\n");
+    return -1;
+  }
+  redisxDestroyRESP(reply);
+
+  if(checkIdle("block") != 0) return -1;
+
+  sendWrites(1);
+  request("ECHO", "after");
+  if(respond(peer, "+OK\r\n$5\r\nafter\r\n") != 0) return -1;
+  if(expect("after block", "after") != 0) return -1;
+
+  return checkIdle("after block");
+}
+
+int main() {
+  Redis *redis;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  cl = redis->interactive;
+  cp = (ClientPrivate *) cl->priv;
+  peer = openTestClient(cl);
+  if(peer < 0) return 1;
+
+  // The request and reply counters need not be in step for the discard.
+  cp->replySeq += 5;
+
+  redisxLockClient(cl);
+
+  if(testBracketing() != 0) return 1;
+  if(testRepeated() != 0) return 1;
+  if(testBlock() != 0) return 1;
+
+  redisxUnlockClient(cl);
+
+  closeTestClient(cl, peer);
+
+  printf("OK\n");
+  return 0;
+}
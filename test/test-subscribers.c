@@ -0,0 +1,182 @@
+/**
+ * @file
+ *
+ * Offline test of matching PUB/SUB messages to subscribers by channel stem, of the reclamation of
+ * retired subscriber indices, and of keeping the subscribers of different owners apart.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "redisx-priv.h"
+
+static Redis *redis;
+static int nAll, nFoo, nFooBar, nBar, nNested;
+
+static void onAll(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) channel; (void) msg; (void) length;
+  nAll++;
+}
+
+static void onFoo(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) msg; (void) length;
+  if(strncmp(channel, "foo", 3) == 0) nFoo++;
+}
+
+static void onFooBar(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) msg; (void) length;
+  if(strncmp(channel, "foobar", 6) == 0) nFooBar++;
+}
+
+static void onBar(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) channel; (void) length;
+  if(msg && strcmp(msg, "hello") == 0) nBar++;
+}
+
+static void onNested(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) channel; (void) msg; (void) length;
+  nNested++;
+}
+
+// Modifies the subscribers while a message is being dispatched.
+static void onModify(const char *pattern, const char *channel, const char *msg, long length) {
+  (void) pattern; (void) channel; (void) msg; (void) length;
+  redisxAddSubscriber(redis, "nested", onNested);
+  redisxRemoveSubscribers(redis, onFooBar);
+}
+
+// Dispatches a message, as if received on the subscription client.
+static void deliver(const char *channel, const char *msg) {
+  RESP type = { RESP_BULK_STRING, 7, "message" };
+  RESP ch = { RESP_BULK_STRING, 0, (char *) channel };
+  RESP payload = { RESP_BULK_STRING, 0, (char *) msg };
+  RESP *components[] = { &type, &ch, &payload };
+  RESP reply = { RESP_ARRAY, 3, components };
+
+  ch.n = (int) strlen(channel);
+  payload.n = (int) strlen(msg);
+
+  rProcessSubscriptionReply(redis, &reply);
+}
+
+static void reset() {
+  nAll = nFoo = nFooBar = nBar = nNested = 0;
+}
+
+static int check(const char *what, int n, int expected) {
+  if(n == expected) return 0;
+  fprintf(stderr, "ERROR! %s: %d calls, expected %d\n", what, n, expected);
+  return -1;
+}
+
+int main() {
+  RedisPrivate *p;
+
+  redis = redisxInit("localhost");
+  if(!redis) {
+    fprintf(stderr, "ERROR! init\n");
+    return 1;
+  }
+
+  p = (RedisPrivate *) redis->priv;
+
+  redisxAddSubscriber(redis, NULL, onAll);
+  redisxAddSubscriber(redis, "foo", onFoo);
+  redisxAddSubscriber(redis, "foobar", onFooBar);
+  redisxAddSubscriber(redis, "bar", onBar);
+  redisxAddSubscriber(redis, "", onBar);
+
+  deliver("foo", "hello");
+  deliver("foobar", "hello");
+  deliver("foobarbaz", "hello");
+  deliver("fo", "hello");
+  deliver("bar", "hello");
+  deliver("baz", "world");
+
+  if(check("all", nAll, 6) != 0) return 1;
+  if(check("foo", nFoo, 3) != 0) return 1;
+  if(check("foobar", nFooBar, 2) != 0) return 1;
+  if(check("bar + empty", nBar, 5 + 1) != 0) return 1;
+
+  // Removed subscribers are no longer called.
+  reset();
+  redisxRemoveSubscribers(redis, onFoo);
+  deliver("foobar", "hello");
+  if(check("removed foo", nFoo, 0) != 0) return 1;
+  if(check("remaining foobar", nFooBar, 1) != 0) return 1;
+
+  // Nothing is retired while no message is being dispatched.
+  if(p->retiredIndex) {
+    fprintf(stderr, "ERROR! retired index not freed\n");
+    return 1;
+  }
+
+  // Changes made during dispatch take effect for the next message, while the index that is in use is
+  // kept until the next change.
+  reset();
+  redisxAddSubscriber(redis, "foo", onModify);
+  deliver("foobar", "hello");
+  if(check("during change", nFooBar, 1) != 0) return 1;
+
+  if(!p->retiredIndex) {
+    fprintf(stderr, "ERROR! index in use was freed\n");
+    return 1;
+  }
+
+  reset();
+  deliver("foobar", "hello");
+  deliver("nested", "hello");
+  if(check("removed during dispatch", nFooBar, 0) != 0) return 1;
+  if(check("added during dispatch", nNested, 1) != 0) return 1;
+
+  redisxRemoveSubscribers(redis, onModify);
+  if(p->retiredIndex) {
+    fprintf(stderr, "ERROR! retired index not freed after dispatch\n");
+    return 1;
+  }
+
+  // The same function may be listed for all channels and for a stem also.
+  reset();
+  redisxAddSubscriber(redis, "x", onAll);
+  deliver("xyz", "hello");
+  if(check("all + stem", nAll, 2) != 0) return 1;
+
+  // Subscribers added on behalf of an owner (e.g. a cluster) are removed separately from the user's.
+  reset();
+  rAddSubscriber(redis, "foo", onFoo, p);
+  redisxAddSubscriber(redis, "foo", onFoo);
+  deliver("foo", "hello");
+  if(check("owned + user", nFoo, 2) != 0) return 1;
+
+  reset();
+  if(check("removed owned", rRemoveSubscribers(redis, onFoo, p), 1) != 0) return 1;
+  deliver("foo", "hello");
+  if(check("user after owned removed", nFoo, 1) != 0) return 1;
+
+  reset();
+  rAddSubscriber(redis, "foo", onFoo, p);
+  if(check("removed user", redisxRemoveSubscribers(redis, onFoo), 1) != 0) return 1;
+  deliver("foo", "hello");
+  if(check("owned after user removed", nFoo, 1) != 0) return 1;
+
+  // No subscribers, no index.
+  redisxClearSubscribers(redis);
+  if(p->subscriberIndex || p->retiredIndex) {
+    fprintf(stderr, "ERROR! index not cleared\n");
+    return 1;
+  }
+
+  reset();
+  deliver("foo", "hello");
+  if(check("cleared", nAll, 0) != 0) return 1;
+
+  redisxDestroy(redis);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file
+ *
+ * Offline test of dispatching PUB/SUB messages via subscriber worker threads, with messages received by the
+ * shared event loop, via local socket pairs in place of server connections. The loop must not wait for room
+ * in a full queue, and must not grow it either, but drop the messages instead.
+ *
+ * @date Created  on Oct 17, 2026
+ * @author Attila Kovacs
+ */
+
+
+#include <sys/ioctl.h>
+
+#include "test-fixture.h"
+
+#define N_MESSAGES        50      ///< messages per channel, many more than the queues hold.
+#define QUEUE_LENGTH      2
+#define MAX_HELD          (2 * (QUEUE_LENGTH + 1))  ///< messages the 2 held-up workers may take in at most.
+
+static volatile int isOpen, nPipeline, nDelivered, nOutOfOrder;
+static int last[2] = { -1, -1 };
+
+static void onMessage(const char *pattern, const char *channel, const char *msg, long length) {
+  int k = channel[0] == 'a' ? 0 : 1;
+  int i = atoi(msg);
+
+  (void) pattern;
+  (void) length;
+
+  // Hold up the workers until released.
+  while(!isOpen) usleep(WAIT_STEP_MICROS);
+
+  // Each channel is served by a single worker, so no locking needed. Messages may be dropped, but not reordered.
+  if(i <= last[k]) nOutOfOrder++;
+  last[k] = i;
+
+  __atomic_add_fetch(&nDelivered, 1, __ATOMIC_SEQ_CST);
+}
+
+static void consume(RESP *reply) {
+  (void) reply;
+  nPipeline++;
+}
+
+// Waits until the client has read all data from its socket, and processed what it has buffered.
+static int waitDrained(RedisClient *cl) {
+  ClientPrivate *cp = (ClientPrivate *) cl->priv;
+  int i;
+
+  for(i = 0; i < WAIT_STEPS; i++) {
+    int n = 0;
+
+    if(ioctl(cp->socket, FIONREAD, &n) == 0 && n == 0) {
+      pthread_mutex_lock(&cp->readLock);
+      n = cp->available - cp->next;
+      pthread_mutex_unlock(&cp->readLock);
+      if(n <= 0) return 0;
+    }
+
+    usleep(WAIT_STEP_MICROS);
+  }
+
+  return -1;
+}
+
+int main() {
+  Redis *redis;
+  RedisPrivate *p;
+  int i, sub, pipe;
+
+  redis = initTest();
+  if(!redis) return 1;
+
+  p = (RedisPrivate *) redis->priv;
+
+  redisxUseEventLoop(redis, TRUE);
+  redisxSetSubscriberWorkers(redis, 2, QUEUE_LENGTH, FALSE);
+  redisxSetPipelineConsumer(redis, consume);
+  redisxAddSubscriber(redis, NULL, onMessage);
+
+  if(redisxStartEventLoop(1) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! start event loop\n");
+    return 1;
+  }
+
+  sub = openTestClient(redis->subscription);
+  pipe = openTestClient(redis->pipeline);
+  if(sub < 0 || pipe < 0) return 1;
+
+  // Starts the workers, and adds the subscription client to the loop.
+  if(redisxSubscribe(redis, "a") != X_SUCCESS) {
+    fprintf(stderr, "ERROR! subscribe\n");
+    return 1;
+  }
+
+  p->isPipelineListenerEnabled = TRUE;
+  if(rLoopAddClientAsync(redis->pipeline) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! add pipeline client to loop\n");
+    return 1;
+  }
+
+  for(i = 0; i < N_MESSAGES; i++) {
+    char buf[100];
+    int k;
+
+    for(k = 0; k < 2; k++) {
+      int L = sprintf(buf, "*3\r\n$7\r\nmessage\r\n$1\r\n%c\r\n$%d\r\n%d\r\n", 'a' + k, i < 10 ? 1 : 2, i);
+      if(write(sub, buf, L) != L) {
+        perror("ERROR! write");
+        return 1;
+      }
+    }
+  }
+
+  // While the workers are held up, the loop must keep servicing other clients.
+  if(respond(pipe, ":1\r\n") != 0 || waitFor(&nPipeline, 1) != 0) {
+    fprintf(stderr, "ERROR! event loop blocked by full subscriber queue\n");
+    return 1;
+  }
+
+  if(waitDrained(redis->subscription) != 0) {
+    fprintf(stderr, "ERROR! subscription messages not processed\n");
+    return 1;
+  }
+
+  isOpen = TRUE;
+
+  // Let the workers deliver all they have taken in.
+  for(i = 0; i < WAIT_STEPS; i++) {
+    int n = nDelivered;
+    usleep(10 * WAIT_STEP_MICROS);
+    if(nDelivered == n) break;
+  }
+
+  if(nDelivered < 2 || nDelivered > MAX_HELD) {
+    fprintf(stderr, "ERROR! delivered %d messages, expected 2 to %d\n", nDelivered, MAX_HELD);
+    return 1;
+  }
+
+  if(nOutOfOrder) {
+    fprintf(stderr, "ERROR! %d messages out of order\n", nOutOfOrder);
+    return 1;
+  }
+
+  redisxStopEventLoop();
+  redisxDestroy(redis);
+
+  printf("OK\n");
+  return 0;
+}